@@ -0,0 +1,60 @@
+//implementation file for the batch mode output
+
+#include "BatchOutput.h"
+#include <cstdio>
+#include <charconv>
+using namespace std;
+
+BatchOutput::BatchOutput(FILE* _file) : file(_file) {
+    if (file != NULL) {
+        buffer.reserve(SIZE + 256); //a bit extra since it only gets written once it's over SIZE
+    }
+}
+BatchOutput::~BatchOutput() {
+    flush();
+}
+
+BatchOutput& BatchOutput::operator<<(string_view text) {
+    buffer += text;
+    wrote();
+    return *this;
+}
+BatchOutput& BatchOutput::operator<<(const char* text) {
+    buffer += text;
+    wrote();
+    return *this;
+}
+BatchOutput& BatchOutput::operator<<(char letter) {
+    buffer += letter;
+    wrote();
+    return *this;
+}
+BatchOutput& BatchOutput::operator<<(long long number) {
+    char digits[24];
+    char* end = to_chars(digits, digits + sizeof(digits), number).ptr; //to_chars doesn't go through the locale like cout and printf do, so it's way faster
+    buffer.append(digits, end);
+    wrote();
+    return *this;
+}
+BatchOutput& BatchOutput::operator<<(double number) {
+    char digits[64];
+    int length = snprintf(digits, sizeof(digits), "%.2f", number);
+    buffer.append(digits, length);
+    wrote();
+    return *this;
+}
+
+void BatchOutput::flush() {
+    if (file == NULL) { //nothing to write to, whoever owns it takes the text out themselves
+        return;
+    }
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    fflush(file);
+    buffer.clear();
+}
+
+void BatchOutput::wrote() {
+    if (file != NULL && buffer.size() >= SIZE) {
+        flush();
+    }
+}
@@ -0,0 +1,42 @@
+//header file for the batch mode output, which collects everything printed in one big buffer and only writes it out once it's full, instead
+//of going through cout a few times for every single line. The server uses it too, one per connection, but without a file: it just collects
+//the replies and the server sends them once it's answered everything the client had sent
+
+#ifndef BATCH_OUTPUT
+#define BATCH_OUTPUT
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+class BatchOutput {
+public:
+    static const size_t SIZE = 1 << 20; //how much gets collected before it's written
+
+    BatchOutput(FILE* _file = stdout); //writes into the given file, or never writes anything if it's NULL
+    ~BatchOutput(); //writes whatever is left
+    BatchOutput(const BatchOutput&) = delete;
+    BatchOutput& operator=(const BatchOutput&) = delete;
+
+    BatchOutput& operator<<(std::string_view text); //adds the text
+    BatchOutput& operator<<(const char* text);
+    BatchOutput& operator<<(char letter);
+    BatchOutput& operator<<(long long number); //adds the number
+    BatchOutput& operator<<(int number) { //the other integer types, so they don't have to pick between char, long long, and double
+        return *this << (long long)number;
+    }
+    BatchOutput& operator<<(size_t number) {
+        return *this << (long long)number;
+    }
+    BatchOutput& operator<<(double number); //adds the number with two decimals, like the GPAs everywhere else
+    void flush(); //writes out everything collected so far
+    std::string& text() { //everything collected and not written yet, for whoever writes it out themselves
+        return buffer;
+    }
+private:
+    void wrote(); //writes the buffer out if it's full
+    std::string buffer;
+    FILE* file;
+};
+#endif
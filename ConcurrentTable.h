@@ -0,0 +1,212 @@
+//header file for the concurrent hash table, the thread safe cousin of the chained HashTable. The table is split into shards, picked by the top
+//bits of the hash, and every shard is its own little chained table with its own lock and its own length, so writers in different shards never
+//wait on each other and a resize only stops one shard. Readers don't lock anything at all: every link is atomic, writers only ever publish
+//fully built nodes, and unlinked nodes (and the bucket arrays of resized shards) get retired to the Epochs instead of deleted, so a reader
+//can never land on freed memory. A shard doubles like HashTable does: once it has more nodes than buckets, or early when a chain gets longer
+//than 3 while it's at least half full, so a few clustered keys can't blow it up on their own. Shards never shrink.
+//Since a reader can be walking a chain while the shard resizes, nodes can't be moved over into the new buckets (a reader following a moved
+//node would end up in the wrong chain and miss its key), so a resize copies every node of the shard into the new array and retires the old ones
+//(no .cpp because templates have to be in headers)
+
+#ifndef CONCURRENT_TABLE
+#define CONCURRENT_TABLE
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include "Epoch.h"
+
+template <class K, class V, class Hasher, class KeyEqual = std::equal_to<K> >
+class ConcurrentTable {
+public:
+    typedef uint64_t hash_type; //what the hasher makes, which gets stored in the nodes
+    static const size_t SHARD_BITS = 6; //the top this many bits of the hash pick the shard
+    static const size_t SHARDS = (size_t)1 << SHARD_BITS;
+
+    ConcurrentTable(size_t _shardlen = 16) { //creates an empty table where every shard has at least the given amount of buckets
+        size_t len = 1;
+        while (len < _shardlen) { //rounded up to a power of two so we can mask instead of modulo
+            len *= 2;
+        }
+        for (size_t s = 0; s < SHARDS; s++) {
+            shards[s].buckets.store(new Buckets(len), std::memory_order_relaxed);
+            shards[s].count.store(0, std::memory_order_relaxed);
+        }
+    }
+    ~ConcurrentTable() { //nobody can be using the table anymore, so everything can be deleted right away without retiring it
+        for (size_t s = 0; s < SHARDS; s++) {
+            deleteAll(shards[s].buckets.load(std::memory_order_relaxed));
+        }
+    }
+    ConcurrentTable(const ConcurrentTable&) = delete;
+    ConcurrentTable& operator=(const ConcurrentTable&) = delete;
+
+    //hashes the given key, public so callers can hash once and reuse it
+    hash_type hash(const K& key) const {
+        return hasher(key);
+    }
+
+    //inserts the key and value, returns false without inserting if the key is already in the table. Locks the key's shard
+    bool insert(const K& key, const V& value) {
+        return insert(key, value, hash(key));
+    }
+    bool insert(const K& key, const V& value, hash_type keyHash) {
+        Shard& shard = shardOf(keyHash);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        Buckets* buckets = shard.buckets.load(std::memory_order_relaxed); //only writers change it and we're the writer
+        std::atomic<Node*>& head = buckets->heads[keyHash & (buckets->len - 1)];
+        size_t chainlen = 1; //how long the chain will be, including the new node
+        for (Node* current = head.load(std::memory_order_relaxed); current != NULL; current = current->next.load(std::memory_order_relaxed)) {
+            if (current->hash == keyHash && equal(current->key, key)) { //no repeating keys
+                return false;
+            }
+            chainlen++;
+        }
+        Node* node = new Node(key, value, keyHash);
+        node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        head.store(node, std::memory_order_release); //publishes the node, release so readers that see it also see everything in it
+        size_t count = shard.count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (count > buckets->len || (chainlen > 3 && count >= buckets->len / 2)) { //same rule as HashTable, but only this shard gets doubled
+            grow(shard);
+        }
+        return true;
+    }
+
+    //deletes the node with the given key, returns false if there was no such key. Locks the key's shard, the node itself gets deleted once no reader can have it
+    bool erase(const K& key) {
+        return erase(key, hash(key));
+    }
+    bool erase(const K& key, hash_type keyHash) {
+        Shard& shard = shardOf(keyHash);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        Buckets* buckets = shard.buckets.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = &buckets->heads[keyHash & (buckets->len - 1)]; //the link pointing at current, so we can bridge over it
+        for (Node* current = link->load(std::memory_order_relaxed); current != NULL; current = link->load(std::memory_order_relaxed)) {
+            if (current->hash == keyHash && equal(current->key, key)) {
+                //readers already on the node still follow its next to the rest of the chain, since we don't touch it
+                link->store(current->next.load(std::memory_order_relaxed), std::memory_order_release);
+                shard.count.fetch_sub(1, std::memory_order_relaxed);
+                Epochs::domain().retire(current);
+                return true;
+            }
+            link = &current->next;
+        }
+        return false;
+    }
+
+    //copies the value of the given key into out and returns true, or returns false if the key isn't in the table. Never locks
+    bool find(const K& key, V& out) const {
+        return visit(key, [&](const V& value) { out = value; });
+    }
+    bool find(const K& key, V& out, hash_type keyHash) const {
+        return visit(key, [&](const V& value) { out = value; }, keyHash);
+    }
+    //calls f with the value of the given key and returns true, or returns false if the key isn't in the table. Never locks, and the value
+    //is only guaranteed to stay alive while f runs, so f shouldn't keep any pointers to it
+    template <class F>
+    bool visit(const K& key, F f) const {
+        return visit(key, f, hash(key));
+    }
+    template <class F>
+    bool visit(const K& key, F f, hash_type keyHash) const {
+        Epochs::Guard guard; //nothing we can reach gets deleted until we're done
+        const Shard& shard = shardOf(keyHash);
+        Buckets* buckets = shard.buckets.load(std::memory_order_acquire);
+        for (Node* current = buckets->heads[keyHash & (buckets->len - 1)].load(std::memory_order_acquire); current != NULL;
+             current = current->next.load(std::memory_order_acquire)) {
+            if (current->hash == keyHash && equal(current->key, key)) {
+                f(static_cast<const V&>(current->value));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t size() const { //how many entries are in the table, only exact if nobody is writing at the same time
+        size_t total = 0;
+        for (size_t s = 0; s < SHARDS; s++) {
+            total += shards[s].count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+    bool empty() const {
+        return size() == 0;
+    }
+    size_t bucketCount() const { //the length of every shard added up
+        Epochs::Guard guard; //a shard could be resizing and retire the array we're looking at
+        size_t total = 0;
+        for (size_t s = 0; s < SHARDS; s++) {
+            total += shards[s].buckets.load(std::memory_order_acquire)->len;
+        }
+        return total;
+    }
+private:
+    struct Node { //like the chained table's nodes, but the link is atomic so readers can follow it while writers change it
+        Node(const K& _key, const V& _value, hash_type _hash) : key(_key), value(_value), hash(_hash), next(NULL) {}
+        K key;
+        V value;
+        hash_type hash;
+        std::atomic<Node*> next;
+    };
+    struct Buckets { //a shard's table, kept together with its length so a reader always gets a matching pair
+        Buckets(size_t _len) : len(_len), heads(new std::atomic<Node*>[_len]()) {}
+        ~Buckets() {
+            delete[] heads;
+        }
+        size_t len;
+        std::atomic<Node*>* heads;
+    };
+    struct alignas(64) Shard { //on its own cache lines so the locks of neighbouring shards don't fight over one
+        std::mutex lock; //held by whoever is writing to the shard
+        std::atomic<Buckets*> buckets;
+        std::atomic<size_t> count; //atomic so size() can read it without the lock
+    };
+
+    Shard& shardOf(hash_type keyHash) {
+        return shards[keyHash >> (64 - SHARD_BITS)]; //the top bits, the index uses the bottom ones so the two don't overlap
+    }
+    const Shard& shardOf(hash_type keyHash) const {
+        return shards[keyHash >> (64 - SHARD_BITS)];
+    }
+
+    //doubles the shard by copying every node into a new array twice as long, needs the shard's lock
+    void grow(Shard& shard) {
+        Buckets* old = shard.buckets.load(std::memory_order_relaxed);
+        size_t newlen = old->len * 2;
+        Buckets* buckets = new Buckets(newlen);
+        for (size_t i = 0; i < old->len; i++) {
+            for (Node* current = old->heads[i].load(std::memory_order_relaxed); current != NULL; current = current->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node*>& head = buckets->heads[current->hash & (newlen - 1)];
+                Node* copy = new Node(current->key, current->value, current->hash);
+                copy->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                head.store(copy, std::memory_order_relaxed); //nobody can see the new array yet
+            }
+        }
+        shard.buckets.store(buckets, std::memory_order_release); //publishes the new array with every copy in it
+        for (size_t i = 0; i < old->len; i++) { //the old nodes and array can still be in use by readers
+            Node* next;
+            for (Node* current = old->heads[i].load(std::memory_order_relaxed); current != NULL; current = next) {
+                next = current->next.load(std::memory_order_relaxed); //before retiring, since with no readers around it can get deleted right away
+                Epochs::domain().retire(current);
+            }
+        }
+        Epochs::domain().retire(old);
+    }
+    static void deleteAll(Buckets* buckets) { //deletes an array that no reader can see, and every node in it
+        for (size_t i = 0; i < buckets->len; i++) {
+            Node* next;
+            for (Node* current = buckets->heads[i].load(std::memory_order_relaxed); current != NULL; current = next) {
+                next = current->next.load(std::memory_order_relaxed);
+                delete current;
+            }
+        }
+        delete buckets;
+    }
+
+    Shard shards[SHARDS];
+    Hasher hasher;
+    KeyEqual equal;
+};
+#endif
@@ -0,0 +1,76 @@
+//implementation file for the cuckoo filter
+
+#include "CuckooFilter.h"
+using namespace std;
+
+CuckooFilter::CuckooFilter(size_t capacity) : kicks(0) {
+    reset(capacity);
+}
+
+void CuckooFilter::reset(size_t capacity) {
+    size_t len = 16; //never tiny, so a handful of IDs doesn't make it rebuild over and over
+    while (len * SLOTS * MAX_LOAD_PERCENT / 100 < capacity) {
+        len *= 2;
+    }
+    buckets.assign(len, 0);
+    buckets.shrink_to_fit(); //so shrinking it actually gives the memory back
+    mask = len - 1;
+    count = 0;
+}
+
+void CuckooFilter::clear() {
+    fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+}
+
+bool CuckooFilter::place(uint64_t& bucket, uint16_t print) {
+    for (size_t slot = 0; slot < SLOTS; slot++) {
+        if (((bucket >> (slot * 16)) & 0xFFFF) == 0) {
+            bucket |= (uint64_t)print << (slot * 16);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::take(uint64_t& bucket, uint16_t print) {
+    for (size_t slot = 0; slot < SLOTS; slot++) {
+        if (((bucket >> (slot * 16)) & 0xFFFF) == print) {
+            bucket &= ~((uint64_t)0xFFFF << (slot * 16));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::insert(int id) {
+    uint64_t h = MixHasher()(id);
+    uint16_t print = fingerprint(h);
+    size_t bucket = h & mask;
+    count++;
+    if (place(buckets[bucket], print) || place(buckets[alternate(bucket, print)], print)) {
+        return true;
+    }
+    //both buckets are full, so a fingerprint already in one of them gets kicked out to its other bucket, which might kick out another, and so on
+    bucket = kicks & 1 ? bucket : alternate(bucket, print);
+    for (size_t kick = 0; kick < MAX_KICKS; kick++) {
+        size_t slot = kicks++ % SLOTS;
+        uint16_t kicked = (buckets[bucket] >> (slot * 16)) & 0xFFFF;
+        buckets[bucket] = (buckets[bucket] & ~((uint64_t)0xFFFF << (slot * 16))) | ((uint64_t)print << (slot * 16));
+        print = kicked;
+        bucket = alternate(bucket, print);
+        if (place(buckets[bucket], print)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CuckooFilter::remove(int id) {
+    uint64_t h = MixHasher()(id);
+    uint16_t print = fingerprint(h);
+    size_t bucket = h & mask;
+    if (take(buckets[bucket], print) || take(buckets[alternate(bucket, print)], print)) {
+        count--;
+    }
+}
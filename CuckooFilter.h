@@ -0,0 +1,71 @@
+//header file for the cuckoo filter, a compact "is this ID maybe in the table" check that goes in front of the table so lookups of IDs that
+//aren't there (DELETE of someone who doesn't exist, the "is this ID taken" checks when adding and generating) can usually be answered without
+//hashing the ID with the table's hasher or walking a chain. Every ID becomes a 16-bit fingerprint stored in one of two buckets of 4, and an
+//ID is only maybe there if its fingerprint is in one of its two buckets. It never says no to an ID that's there, and says maybe to about 1
+//in 8000 IDs that aren't. Unlike a Bloom filter it can delete, since the fingerprint to take out is right there in one of the two buckets.
+//A bucket is a single 64-bit word, so checking all 4 fingerprints in it is a couple of bit tricks instead of a loop
+
+#ifndef CUCKOO_FILTER
+#define CUCKOO_FILTER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Hashers.h"
+
+class CuckooFilter {
+public:
+    static const size_t SLOTS = 4; //fingerprints per bucket
+
+    CuckooFilter(size_t capacity = 0); //sized for the given amount of IDs
+
+    //adds the ID, returns false if there was no room even after kicking fingerprints around, and then the filter has to be rebuilt bigger
+    //(one fingerprint is lost when that happens, so the filter can't be trusted until it's rebuilt)
+    bool insert(int id);
+    void remove(int id); //takes the ID out, it has to have been inserted
+    bool mayContain(int id) const { //false means the ID definitely isn't there
+        uint64_t h = MixHasher()(id);
+        uint16_t print = fingerprint(h);
+        size_t first = h & mask;
+        return hasPrint(buckets[first], print) || hasPrint(buckets[alternate(first, print)], print);
+    }
+    void clear();
+    void reset(size_t capacity); //empties the filter and resizes it for the given amount of IDs
+
+    size_t size() const {
+        return count;
+    }
+    size_t capacity() const { //how many IDs fit before it should be rebuilt bigger
+        return buckets.size() * SLOTS * MAX_LOAD_PERCENT / 100;
+    }
+    size_t bytes() const {
+        return buckets.capacity() * sizeof(uint64_t);
+    }
+private:
+    static const size_t MAX_KICKS = 500; //how many fingerprints an insert kicks around before it gives up
+    static const size_t MAX_LOAD_PERCENT = 90; //cuckoo filters with buckets of 4 start failing inserts somewhere past 95% full
+
+    //the fingerprint is the top 16 bits of the hash (the bucket comes from the bottom ones), 0 is saved for empty slots
+    static uint16_t fingerprint(uint64_t h) {
+        uint16_t print = h >> 48;
+        return print == 0 ? 1 : print;
+    }
+    //the other bucket the fingerprint can go in, which works both ways: the alternate of the alternate is the first one again
+    size_t alternate(size_t bucket, uint16_t print) const {
+        return (bucket ^ (print * 0x5bd1e995u)) & mask;
+    }
+    //whether any of the 4 fingerprints in the bucket is print: xoring the print into every slot turns a match into a slot of zeros, and the
+    //usual has-a-zero trick finds a zero slot in all 4 at once
+    static bool hasPrint(uint64_t bucket, uint16_t print) {
+        uint64_t x = bucket ^ (print * 0x0001000100010001ULL);
+        return ((x - 0x0001000100010001ULL) & ~x & 0x8000800080008000ULL) != 0;
+    }
+    static bool place(uint64_t& bucket, uint16_t print); //puts the fingerprint in an empty slot of the bucket, false if it's full
+    static bool take(uint64_t& bucket, uint16_t print); //takes the fingerprint out of the bucket, false if it isn't there
+
+    std::vector<uint64_t> buckets; //a power of two of them, 4 16-bit fingerprints each
+    size_t mask;
+    size_t count;
+    uint64_t kicks; //for picking which fingerprint gets kicked, so it isn't always the same slot
+};
+#endif
@@ -0,0 +1,30 @@
+//header file for the scan cursors the tables hand out, so a scan can be spread over many calls (like PRINT paging through millions of
+//students) while the table keeps changing and even doubling in between. The cursor is a bucket index, but it counts up in reverse bit
+//order (the top bit of the index goes up first), same as Redis's SCAN. A table that doubles splits every bucket b into b and b + oldLength,
+//and since the new bit is the top one, both halves of every bucket the scan already went through come before the cursor in reverse order,
+//and both halves of every bucket it hasn't come after it. So nothing that was there for the whole scan gets skipped, whatever the table does
+//in between (a shrink can make the scan go over some buckets twice, but never skip any)
+//(no .cpp because it's just the one tiny function that the tables want inlined)
+
+#ifndef CURSOR
+#define CURSOR
+
+#include <cstddef>
+#include <cstdint>
+
+//reverses the bits of the 64-bit number
+inline uint64_t reverseBits(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(x); //the bytes are already reversed inside, so swapping them finishes it
+}
+
+//the cursor after the given one in a table whose bucket indices are masked with mask, 0 once the scan is over
+inline size_t nextCursor(size_t cursor, size_t mask) {
+    cursor |= ~mask; //the bits above the mask are set so adding one carries straight out of them
+    cursor = reverseBits(cursor);
+    cursor++;
+    return reverseBits(cursor);
+}
+#endif
@@ -0,0 +1,145 @@
+//header file for epoch based reclamation, which is how the concurrent table knows when a node it unlinked can actually be deleted.
+//Readers don't lock anything, so a reader might still be walking through a node after a writer took it out of its chain. Instead of deleting
+//it right away, the writer retires it, and it only gets deleted once every reader that was around when it was retired has left.
+//Every reader marks itself with the global epoch when it starts reading and clears the mark when it's done, and a retired node gets tagged
+//with the epoch at the time. Once every reader that's still reading has a newer epoch than the tag, nobody can be looking at the node anymore
+//(no .cpp so the header can be used on its own, everything in here is inline)
+
+#ifndef EPOCH
+#define EPOCH
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+class Epochs {
+    struct Reader; //a thread's hold on its slot, defined down below
+public:
+    static const size_t MAX_THREADS = 256; //how many threads can be reading at the same time
+    static const size_t RECLAIM_EVERY = 64; //how many retired objects pile up before we try deleting some
+
+    //marks the thread as reading for as long as the guard exists, so nothing retired in the meantime gets deleted. Guards can be nested
+    class Guard {
+    public:
+        Guard() : reader(Epochs::domain().thisThread()) {
+            if (reader.depth++ == 0) { //only the outermost guard marks the thread
+                reader.slot->epoch.store(Epochs::domain().global.load(), std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst); //the mark has to be visible before we read any pointers, or a writer could miss it
+            }
+        }
+        ~Guard() {
+            if (--reader.depth == 0) {
+                reader.slot->epoch.store(0, std::memory_order_release); //0 means not reading
+            }
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    private:
+        Reader& reader;
+    };
+
+    //the one domain every table shares, so a thread only ever needs one slot
+    static Epochs& domain() {
+        static Epochs epochs;
+        return epochs;
+    }
+
+    //deletes the object once no reader can be looking at it anymore. It has to be unlinked already so no new reader can find it
+    template <class T>
+    void retire(T* object) {
+        retire(object, [](void* p) { delete static_cast<T*>(p); });
+    }
+    void retire(void* object, void (*deleter)(void*)) {
+        std::lock_guard<std::mutex> lock(retiredLock);
+        std::atomic_thread_fence(std::memory_order_seq_cst); //the unlink has to happen before we read the epoch, so newer readers can't find it
+        retired.push_back(Retired{object, deleter, global.load()});
+        if (retired.size() >= RECLAIM_EVERY) {
+            reclaim();
+        }
+    }
+
+    //deletes every retired object that no reader can be looking at, returns how many are still waiting
+    size_t collect() {
+        std::lock_guard<std::mutex> lock(retiredLock);
+        reclaim();
+        return retired.size();
+    }
+
+    ~Epochs() { //by now every thread is done reading, so everything left can go
+        for (Retired& r : retired) {
+            r.deleter(r.object);
+        }
+    }
+private:
+    struct alignas(64) Slot { //one per reading thread, on its own cache line so threads don't slow each other down by writing next to each other
+        std::atomic<uint64_t> epoch; //the epoch the thread started reading in, or 0 if it isn't reading
+        std::atomic<bool> taken; //whether some thread owns this slot
+    };
+    struct Reader { //a thread's hold on its slot, which it gives back when the thread ends
+        Slot* slot;
+        int depth; //how many guards deep the thread is
+        ~Reader() {
+            if (slot != NULL) {
+                slot->taken.store(false, std::memory_order_release);
+            }
+        }
+    };
+    struct Retired { //an object waiting to be deleted
+        void* object;
+        void (*deleter)(void*);
+        uint64_t epoch; //the epoch when it was retired
+    };
+    Epochs() : global(1) { //epochs start at 1 because 0 means not reading
+        for (size_t i = 0; i < MAX_THREADS; i++) {
+            slots[i].epoch.store(0);
+            slots[i].taken.store(false);
+        }
+    }
+
+    //the calling thread's reader, which grabs a free slot the first time the thread reads
+    Reader& thisThread() {
+        thread_local Reader reader = {NULL, 0};
+        if (reader.slot == NULL) {
+            for (size_t i = 0; i < MAX_THREADS && reader.slot == NULL; i++) {
+                bool expected = false;
+                if (slots[i].taken.compare_exchange_strong(expected, true)) {
+                    reader.slot = &slots[i];
+                }
+            }
+            if (reader.slot == NULL) {
+                throw std::runtime_error("too many threads reading at once");
+            }
+        }
+        return reader;
+    }
+
+    //moves the epoch forward and deletes everything retired before the oldest epoch anyone is still reading in, needs retiredLock
+    void reclaim() {
+        global.fetch_add(1); //readers that start from now on get a newer epoch than anything retired so far
+        uint64_t oldest = UINT64_MAX;
+        for (size_t i = 0; i < MAX_THREADS; i++) {
+            uint64_t epoch = slots[i].epoch.load();
+            if (epoch != 0 && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].epoch < oldest) { //everyone reading now started after this was retired, so nobody can have it
+                retired[i].deleter(retired[i].object);
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+
+    std::atomic<uint64_t> global; //the current epoch
+    Slot slots[MAX_THREADS];
+    std::mutex retiredLock; //retiring can happen from writers in different shards at once
+    std::vector<Retired> retired; //everything waiting to be deleted, in the order it was retired
+};
+#endif
@@ -0,0 +1,500 @@
+//header file for the flat hash table, the open addressing alternative to the chained HashTable. It uses groups of 16 control bytes that get
+//checked all at once, and the entries are stored inline in one array instead of behind node pointers. It doubles before it gets 7/8 full and
+//halves once erasing leaves it less than 1/8 full, never below the capacity it started with or was reserved for. Keeps the same TableStats as
+//the chained table, with probes counted in groups instead of nodes (no .cpp because templates have to be in headers)
+
+#ifndef FLAT_TABLE
+#define FLAT_TABLE
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+#include "Parallel.h"
+#include "Cursor.h"
+#include "Stats.h"
+#ifdef __SSE2__
+#include <emmintrin.h> //SSE2 is on every x86-64 cpu, so this is basically always used, otherwise we fall back to checking the bytes one by one
+#endif
+
+template <class K, class V, class Hasher, class KeyEqual = std::equal_to<K> >
+class FlatTable {
+    struct Entry { //what goes in each full slot
+        K key;
+        V value;
+    };
+public:
+    typedef uint64_t hash_type; //what the hasher makes
+    typedef Hasher hasher_type;
+    static const size_t GROUP = 16; //how many control bytes get compared at once, one SSE2 register's worth
+    static const size_t FIND_BATCH = 16; //how many keys findMany looks for at once
+    static const size_t MIN_LOAD_PERCENT = 12; //shrinks once erasing leaves it less full than this (about 1/8), down to about half full
+
+    //iterates through the full slots, dereferences to the value
+    class iterator {
+    public:
+        iterator(FlatTable* _table, size_t _index) : table(_table), index(_index) {
+            skipEmpty();
+        }
+        V& operator*() {
+            return table->slots[index].value;
+        }
+        V* operator->() {
+            return &table->slots[index].value;
+        }
+        const K& key() { //the key of the current slot, since dereferencing gives the value
+            return table->slots[index].key;
+        }
+        hash_type hash() { //the stored hash of the current slot
+            return table->hashes[index];
+        }
+        iterator& operator++() {
+            index++;
+            skipEmpty();
+            return *this;
+        }
+        bool operator==(const iterator& other) const {
+            return index == other.index;
+        }
+        bool operator!=(const iterator& other) const {
+            return index != other.index;
+        }
+    private:
+        void skipEmpty() { //moves forward until we land on a full slot or go off the end
+            while (index < table->cap && table->ctrl[index] < 0) {
+                index++;
+            }
+        }
+        FlatTable* table;
+        size_t index;
+    };
+
+    FlatTable(size_t _capacity = 128) { //creates an empty table with at least the given capacity, rounded up to a power of two multiple of the group size
+        allocate(roundUp(_capacity));
+        minCap = cap;
+        shrinking = true;
+        tableStats.sized(cap);
+    }
+    ~FlatTable() { //destroys every entry stored inline and frees the slots and control bytes (not clear(), that would allocate new ones first)
+        destroyEntries();
+        release();
+    }
+    FlatTable(const FlatTable&) = delete;
+    FlatTable& operator=(const FlatTable&) = delete;
+
+    //hashes the given key, public so callers can hash once and reuse it for both find and insert
+    hash_type hash(const K& key) const {
+        if (!tableStats.sampleHash()) {
+            return hasher(key);
+        }
+        TableStats::Timer timer(true);
+        hash_type keyHash = hasher(key);
+        tableStats.hashed(timer);
+        return keyHash;
+    }
+    void hash(const K* keys, size_t n, hash_type* out) const { //hashes n keys at once, which some hashers can do faster than one at a time
+        if (!tableStats.sampleHash()) {
+            hasher(keys, n, out);
+            return;
+        }
+        TableStats::Timer timer(true);
+        hasher(keys, n, out);
+        tableStats.hashed(timer, n);
+    }
+
+    //copies the key and value into the table, returns false without inserting if the key is already taken
+    bool insert(const K& key, const V& value) {
+        return insert(key, value, hash(key));
+    }
+    bool insert(const K& key, const V& value, hash_type folded) {
+        TableStats::Timer timer(tableStats.sampleInsert());
+        if (findSlot(key, folded) != cap) { //no duplicate keys allowed
+            return false;
+        }
+        place(key, value, folded, timer);
+        return true;
+    }
+
+    //returns the value associated with the given key, or NULL if there isn't one
+    V* find(const K& key) {
+        return find(key, hash(key));
+    }
+    V* find(const K& key, hash_type keyHash) {
+        size_t i = findSlot(key, keyHash);
+        return i == cap ? NULL : &slots[i].value;
+    }
+    //finds n keys at once, out[i] is the value of keys[i] or NULL. Same idea as the chained table's findMany, except the chain of loads is
+    //the home group's control bytes and then the slot they point at: the keys go FIND_BATCH at a time, every home group gets prefetched, then
+    //every slot whose control byte matches, and only then does each key get looked up for real, with both already on their way from memory
+    void findMany(const K* keys, size_t n, V** out) {
+        hash_type hashes[FIND_BATCH];
+        size_t groups = cap / GROUP;
+        for (size_t start = 0; start < n; start += FIND_BATCH) {
+            size_t batch = n - start < FIND_BATCH ? n - start : FIND_BATCH;
+            hash(keys + start, batch, hashes);
+            for (size_t i = 0; i < batch; i++) {
+                __builtin_prefetch(ctrl + h1(hashes[i], groups) * GROUP);
+            }
+            for (size_t i = 0; i < batch; i++) { //the first matching slot is almost always the one, further probing is rare at 7/8 full
+                size_t g = h1(hashes[i], groups);
+                uint32_t mask = matchByte(ctrl + g * GROUP, h2(hashes[i]));
+                if (mask) {
+                    __builtin_prefetch(&slots[g * GROUP + __builtin_ctz(mask)]);
+                }
+            }
+            for (size_t i = 0; i < batch; i++) {
+                size_t slot = findSlot(keys[start + i], hashes[i]);
+                out[start + i] = slot == cap ? NULL : &slots[slot].value;
+            }
+        }
+    }
+
+    //removes the entry with the given key, returns false if not found
+    bool erase(const K& key) {
+        return erase(key, hash(key));
+    }
+    bool erase(const K& key, hash_type keyHash) {
+        size_t i = findSlot(key, keyHash);
+        if (i == cap) {
+            return false;
+        }
+        slots[i].~Entry();
+        //if the group still has an empty slot, no probe sequence could have continued past it, so we can mark it empty instead of leaving a tombstone
+        if (matchByte(ctrl + (i / GROUP) * GROUP, EMPTY)) {
+            ctrl[i] = EMPTY;
+        } else {
+            ctrl[i] = DELETED;
+            tombstones++;
+        }
+        count--;
+        tableStats.erased();
+        if (shrinking && cap > minCap && count * 100 < cap * MIN_LOAD_PERCENT) { //all at once like growing, but it took a lot of erases to get here
+            size_t newCap = cap;
+            while (newCap / 2 >= minCap && count * 2 <= newCap / 2) {
+                newCap /= 2;
+            }
+            rebuild(newCap);
+        }
+        return true;
+    }
+
+    //inserts n keys at once and returns how many were actually inserted, with make(i) building the value for keys[i]. Same as the chained
+    //table's bulkInsert, but only the hashing is spread over the threads: probe sequences run into each other across the whole table, so
+    //the slots can't be split up between threads like buckets can. It still only grows once, and make gets called on this thread, once
+    //for every key inserted and never for the skipped ones
+    template <class Make>
+    size_t bulkInsert(const K* keys, size_t n, Make make, unsigned threads = defaultThreads()) {
+        return bulkInsert(keys, (const hash_type*)NULL, n, make, threads);
+    }
+    //same thing, but if keyHashes isn't NULL the keys are already hashed and nothing gets hashed at all
+    template <class Make>
+    size_t bulkInsert(const K* keys, const hash_type* keyHashes, size_t n, Make make, unsigned threads = defaultThreads()) {
+        growFor(count + n); //not reserve, that would stop the table from shrinking back down once they're deleted
+        std::vector<hash_type> computed(keyHashes == NULL ? n : 0);
+        if (keyHashes == NULL) {
+            parallelFor(n, threads ? threads : 1, [&](size_t begin, size_t end, unsigned) {
+                const size_t BATCH = 256;
+                for (size_t i = begin; i < end; i += BATCH) {
+                    hasher(keys + i, end - i < BATCH ? end - i : BATCH, computed.data() + i);
+                }
+            });
+        }
+        const hash_type* hashes = keyHashes == NULL ? computed.data() : keyHashes;
+        size_t inserted = 0;
+        for (size_t i = 0; i < n; i++) {
+            TableStats::Timer timer(tableStats.sampleInsert());
+            if (findSlot(keys[i], hashes[i]) == cap) { //skip keys that are already in, before making their value, and don't look again after
+                place(keys[i], make(i), hashes[i], timer);
+                inserted++;
+            }
+        }
+        return inserted;
+    }
+
+    //makes sure the given amount of entries fits without growing, and that the table doesn't shrink below that again either, even if they
+    //all get erased
+    void reserve(size_t entries) {
+        size_t needed = capacityFor(entries);
+        if (needed > minCap) {
+            minCap = needed;
+        }
+        growFor(entries);
+    }
+
+    //destroys every entry and goes back to the capacity the table started with (or was reserved for)
+    void clear() {
+        destroyEntries();
+        if (cap != minCap) {
+            tableStats.reclaimed((cap - minCap) * (sizeof(Entry) + sizeof(uint64_t) + 1));
+            release();
+            allocate(minCap);
+            return;
+        }
+        memset(ctrl, EMPTY, cap);
+        count = 0;
+        tombstones = 0;
+    }
+
+    size_t size() const { //how many entries are in the table
+        return count;
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    size_t capacity() const { //how many slots the table has
+        return cap;
+    }
+    size_t bytes() const { //how much memory the table takes up: every slot has an entry, a hash and a control byte whether it's full or not
+        return cap * (sizeof(Entry) + sizeof(uint64_t) + 1);
+    }
+    const TableStats& stats() const {
+        return tableStats;
+    }
+    TableShape shape() const { //how many groups into its probe sequence every entry ended up, found by walking the sequence from its home group
+        TableShape result;
+        result.entries = count;
+        result.slots = cap;
+        result.bytes = bytes();
+        result.lengthName = "probe";
+        result.lengths.assign(TableStats::BINS, 0);
+        size_t groups = cap / GROUP;
+        for (size_t i = 0; i < cap; i++) {
+            if (ctrl[i] < 0) {
+                continue;
+            }
+            size_t probes = 1;
+            for (size_t g = h1(hashes[i], groups), step = 1; g != i / GROUP; step++) {
+                g = (g + step) & (groups - 1);
+                probes++;
+            }
+            result.lengths[probes < TableStats::BINS ? probes : TableStats::BINS - 1]++;
+        }
+        return result;
+    }
+
+    iterator begin() {
+        return iterator(this, 0);
+    }
+    iterator end() {
+        return iterator(this, cap);
+    }
+
+    //calls visit(key, value, hash) on every entry whose home group (where its probing starts) is at the cursor or after it (in the cursor's
+    //reverse bit order, see Cursor.h) until at least limit entries were visited or the table ran out, and returns the cursor to continue from
+    //next time, 0 once the whole table is done. Start with 0. The cursor goes over home groups instead of where the entries actually are,
+    //since the home group is just masked hash bits like a chained table's bucket, so it splits the same way when the table doubles and every
+    //entry that's in the table for the whole scan gets visited at least once. An entry is always somewhere on its home group's probe
+    //sequence before the first group with an empty slot (otherwise find couldn't find it either), so that's where the scan looks for them
+    template <class Visit>
+    size_t scan(size_t cursor, size_t limit, Visit visit) {
+        size_t groups = cap / GROUP;
+        size_t visited = 0;
+        do {
+            size_t home = cursor & (groups - 1);
+            size_t g = home;
+            for (size_t step = 1; step <= groups; step++) {
+                for (uint32_t full = ~matchFree(ctrl + g * GROUP) & 0xFFFF; full; full &= full - 1) {
+                    size_t i = g * GROUP + __builtin_ctz(full);
+                    if (h1(hashes[i], groups) == home) { //only the ones that started here, the others get visited from their own home group
+                        visit(slots[i].key, slots[i].value, hashes[i]);
+                        visited++;
+                    }
+                }
+                if (matchByte(ctrl + g * GROUP, EMPTY)) {
+                    break;
+                }
+                g = (g + step) & (groups - 1);
+            }
+            cursor = nextCursor(cursor, groups - 1);
+        } while (cursor != 0 && visited < limit);
+        return cursor;
+    }
+    //whether a scan that's at the cursor (and didn't start over at 0 since) already went past the home group of the entry with the given hash.
+    //The home group is just the hash bits above the 7 for the control byte, so that doesn't depend on the capacity as long as it only grows
+    static bool scanned(size_t cursor, hash_type folded) {
+        return reverseBits(folded >> 7) < reverseBits(cursor);
+    }
+    //turns shrinking on erase off (or back on), since a scan going on while the table halves can visit some entries twice (see Cursor.h)
+    void setShrinking(bool on) {
+        shrinking = on;
+    }
+private:
+    static const int8_t EMPTY = -128; //control byte of a slot that never had anyone in it, stops the probing
+    static const int8_t DELETED = -2; //control byte of a slot whose entry was deleted, probing has to continue past these (tombstones!)
+
+    //returns a bitmask of which of the 16 control bytes starting at group match the given byte
+    static uint32_t matchByte(const int8_t* group, int8_t byte) {
+#ifdef __SSE2__
+        __m128i ctrls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group)); //load all 16 control bytes into one register
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrls, _mm_set1_epi8(byte))); //compare all of them at once and squish the results into 16 bits
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; i++) { //no SIMD, so just compare them one by one
+            mask |= (uint32_t)(group[i] == byte) << i;
+        }
+        return mask;
+#endif
+    }
+    //returns a bitmask of which of the 16 control bytes starting at group are EMPTY or DELETED (both have the top bit set, full slots don't)
+    static uint32_t matchFree(const int8_t* group) {
+#ifdef __SSE2__
+        return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))); //movemask grabs the top bit of each byte, which is exactly what we want
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; i++) {
+            mask |= (uint32_t)(group[i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+    //the 7 bits of the hash stored in the control byte, so most mismatches are ruled out without touching the entry at all
+    static int8_t h2(size_t folded) {
+        return folded & 0x7F;
+    }
+    //the group where the probing for the given hash starts, uses the bits not used by h2
+    static size_t h1(size_t folded, size_t groups) {
+        return (folded >> 7) & (groups - 1);
+    }
+    //round up to a power of two multiple of GROUP so we can mask instead of modulo
+    static size_t roundUp(size_t slots) {
+        size_t rounded = GROUP;
+        while (rounded < slots) {
+            rounded *= 2;
+        }
+        return rounded;
+    }
+
+    //returns the slot of the given key or cap if it's not there
+    size_t findSlot(const K& key, size_t folded) {
+        size_t groups = cap / GROUP;
+        size_t g = h1(folded, groups);
+        for (size_t step = 1; step <= groups; step++) { //triangular probing over the groups, which is guaranteed to visit every group once since the group count is a power of two
+            const int8_t* group = ctrl + g * GROUP;
+            for (uint32_t mask = matchByte(group, h2(folded)); mask; mask &= mask - 1) { //check every slot whose control byte matches
+                size_t i = g * GROUP + __builtin_ctz(mask); //the index of the lowest set bit is the next matching slot
+                if (equal(slots[i].key, key)) {
+                    tableStats.lookup(step); //step is how many groups we've looked at
+                    return i;
+                }
+            }
+            if (matchByte(group, EMPTY)) { //an empty slot means the key would have been placed here if it existed, so it doesn't
+                tableStats.lookup(step);
+                return cap;
+            }
+            g = (g + step) & (groups - 1);
+        }
+        tableStats.lookup(groups);
+        return cap;
+    }
+    //puts a key that isn't in the table yet into the first free slot of its probe sequence, growing first if needed
+    void place(const K& key, const V& value, hash_type folded, TableStats::Timer& timer) {
+        if ((count + tombstones + 1) * 8 > cap * 7) { //keep the load factor under 7/8 (including tombstones), otherwise probe sequences get long
+            rebuild(count * 2 >= cap ? cap * 2 : cap); //only actually double if the table is full of entries, if it's full of tombstones we just rebuild at the same size to clear them
+        }
+        size_t i = findFree(folded);
+        if (ctrl[i] == DELETED) { //reusing a tombstone
+            tombstones--;
+        }
+        TableStats::Timer allocTimer(timer.running());
+        new (&slots[i]) Entry{key, value}; //copy the entry into the slot
+        tableStats.allocated(allocTimer);
+        hashes[i] = folded;
+        ctrl[i] = h2(folded);
+        count++;
+        tableStats.inserted(timer);
+    }
+    //returns the first empty or deleted slot in the probe sequence of the given hash
+    size_t findFree(size_t folded) {
+        size_t groups = cap / GROUP;
+        size_t g = h1(folded, groups);
+        for (size_t step = 1;; step++) { //there is always a free slot because we grow before getting full
+            uint32_t mask = matchFree(ctrl + g * GROUP);
+            if (mask) {
+                return g * GROUP + __builtin_ctz(mask);
+            }
+            g = (g + step) & (groups - 1);
+        }
+    }
+
+    void allocate(size_t slotCount) { //makes new empty arrays with the given amount of slots
+        cap = slotCount;
+        ctrl = new int8_t[cap];
+        memset(ctrl, EMPTY, cap); //every slot starts empty
+        slots = static_cast<Entry*>(::operator new(sizeof(Entry) * cap)); //raw memory, entries only get constructed in full slots
+        hashes = new uint64_t[cap];
+        count = 0;
+        tombstones = 0;
+    }
+    void destroyEntries() { //destroys the entry in every full slot, leaving the control bytes as they are
+        for (size_t i = 0; i < cap; i++) {
+            if (ctrl[i] >= 0) {
+                slots[i].~Entry();
+            }
+        }
+    }
+    void release() { //frees the arrays, the entries have to be destroyed already
+        ::operator delete(slots);
+        delete[] hashes;
+        delete[] ctrl;
+    }
+    static size_t capacityFor(size_t entries) { //enough slots that the entries stay under the 7/8 load factor
+        return roundUp(entries + entries / 7 + 1);
+    }
+    void growFor(size_t entries) { //makes sure there's room for the given amount of entries
+        size_t needed = capacityFor(entries);
+        if (needed > cap) {
+            rebuild(needed);
+        }
+    }
+    //rebuilds the table with the given capacity (bigger, smaller, or the same to clear out the tombstones) and moves all the entries in
+    void rebuild(size_t newCap) {
+        tableStats.resizeStarted();
+        for (size_t len = cap; len < newCap; len *= 2) { //reserve can go up more than one doubling at once
+            tableStats.doubled();
+        }
+        for (size_t len = cap; len > newCap; len /= 2) {
+            tableStats.halved();
+        }
+        if (newCap < cap) {
+            tableStats.reclaimed((cap - newCap) * (sizeof(Entry) + sizeof(uint64_t) + 1));
+        }
+        int8_t* oldCtrl = ctrl;
+        Entry* oldSlots = slots;
+        uint64_t* oldHashes = hashes;
+        size_t oldCap = cap;
+        size_t oldCount = count;
+        allocate(newCap);
+        for (size_t i = 0; i < oldCap; i++) { //move every entry into the new arrays
+            if (oldCtrl[i] >= 0) {
+                size_t folded = oldHashes[i]; //the control byte only has 7 bits of the hash, so we use the stored one
+                size_t j = findFree(folded);
+                new (&slots[j]) Entry(std::move(oldSlots[i]));
+                hashes[j] = folded;
+                ctrl[j] = h2(folded);
+                oldSlots[i].~Entry();
+            }
+        }
+        count = oldCount;
+        ::operator delete(oldSlots);
+        delete[] oldHashes;
+        delete[] oldCtrl;
+        tableStats.sized(cap);
+        tableStats.resizeDone(); //all at once, unlike the chained table
+    }
+
+    int8_t* ctrl; //one control byte per slot: EMPTY, DELETED, or the low 7 bits of the hash if the slot is full
+    Entry* slots; //the entries themselves, stored inline in one array
+    uint64_t* hashes; //the hash of each full slot, so growing doesn't have to run the hasher on every key again
+    size_t cap; //the amount of slots, always a power of two and a multiple of GROUP
+    size_t minCap; //the capacity it never shrinks below, the starting one or whatever reserve asked for
+    size_t count; //the amount of full slots
+    size_t tombstones; //the amount of deleted slots, which still have to be probed past so they count towards the load factor
+    bool shrinking; //whether erases can halve the table, see setShrinking
+    mutable TableStats tableStats; //mutable since hashing is const but still gets timed
+    Hasher hasher;
+    KeyEqual equal;
+};
+#endif
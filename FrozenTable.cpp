@@ -0,0 +1,147 @@
+//implementation file for the frozen table
+
+#include "FrozenTable.h"
+#include <chrono>
+using namespace std;
+
+FrozenTable::FrozenTable() : placeSlots(0), seed(0), isBuilt(false), buildTime(0) {}
+
+void FrozenTable::build(vector<Student>& from) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    clear();
+    //a try only fails if some bucket doesn't fit with any of the 65536 pilots, which basically never happens, but if it does, new hashes fix it
+    for (uint64_t attempt = 1; !tryBuild(from); attempt++) {
+        seed = attempt * 0x9e3779b97f4a7c15ULL;
+    }
+    isBuilt = true;
+    buildTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void FrozenTable::clear() {
+    vector<Student>().swap(students); //swapped with empty ones so the memory actually goes away
+    vector<uint16_t>().swap(pilots);
+    vector<uint32_t>().swap(remap);
+    placeSlots = 0;
+    seed = 0;
+    isBuilt = false;
+}
+
+bool FrozenTable::tryBuild(vector<Student>& from) {
+    size_t n = from.size();
+    if (n == 0) {
+        students.clear();
+        return true;
+    }
+    pilots.assign(n / BUCKET_KEYS + 1, 0);
+    placeSlots = n * 100 / LOAD_PERCENT + 1;
+    size_t buckets = pilots.size();
+
+    //hash everyone and sort them by bucket (counting sort, the buckets are already numbers)
+    vector<uint64_t> hashes(n);
+    vector<uint32_t> bucketStart(buckets + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        hashes[i] = hashID(from[i].getID(), seed);
+        bucketStart[bucketOf(hashes[i]) + 1]++;
+    }
+    size_t biggest = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        biggest = bucketStart[b + 1] > biggest ? bucketStart[b + 1] : biggest;
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    vector<uint32_t> byBucket(n);
+    vector<uint32_t> next(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+        byBucket[next[bucketOf(hashes[i])]++] = i;
+    }
+
+    //the biggest buckets get placed first, while there's still lots of room, since they need all their IDs to land in free slots at once
+    vector<uint32_t> sizeStart(biggest + 2, 0);
+    for (size_t b = 0; b < buckets; b++) {
+        sizeStart[biggest - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+    }
+    for (size_t s = 0; s <= biggest; s++) {
+        sizeStart[s + 1] += sizeStart[s];
+    }
+    vector<uint32_t> bySize(buckets);
+    for (size_t b = 0; b < buckets; b++) {
+        bySize[sizeStart[biggest - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+    }
+
+    //try pilots for every bucket until all of its IDs land in slots that aren't taken (and not the same one as each other)
+    vector<uint64_t> taken((placeSlots + 63) / 64, 0);
+    vector<size_t> slots;
+    for (size_t k = 0; k < buckets; k++) {
+        size_t b = bySize[k];
+        if (bucketStart[b] == bucketStart[b + 1]) { //empty buckets are last, so we're done
+            break;
+        }
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot <= 0xFFFF && !placed; pilot++) {
+            slots.clear();
+            placed = true;
+            for (size_t j = bucketStart[b]; j < bucketStart[b + 1]; j++) {
+                size_t slot = slotOf(hashes[byBucket[j]], pilot);
+                if (taken[slot / 64] >> (slot % 64) & 1) {
+                    placed = false;
+                    break;
+                }
+                taken[slot / 64] |= 1ULL << (slot % 64); //taken right away, so the bucket's other IDs can't land on it either
+                slots.push_back(slot);
+            }
+            if (placed) {
+                pilots[b] = pilot;
+            } else {
+                for (size_t slot : slots) { //give back what this pilot took
+                    taken[slot / 64] &= ~(1ULL << (slot % 64));
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+
+    //every taken slot past the end gets one of the free slots before it, there's exactly as many of those
+    remap.assign(placeSlots - n, 0);
+    size_t free = 0;
+    for (size_t slot = n; slot < placeSlots; slot++) {
+        if (taken[slot / 64] >> (slot % 64) & 1) {
+            while (taken[free / 64] >> (free % 64) & 1) {
+                free++;
+            }
+            remap[slot - n] = free++;
+        }
+    }
+
+    students.assign(n, from[0]); //Student has no default constructor, so they all start as copies of the first
+    for (size_t i = 0; i < n; i++) {
+        students[position(hashes[i])] = from[i];
+    }
+    return true;
+}
+
+void FrozenTable::findMany(const int* ids, size_t n, Student** out) {
+    if (students.empty()) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = NULL;
+        }
+        return;
+    }
+    uint64_t hashes[FIND_BATCH];
+    size_t positions[FIND_BATCH];
+    for (size_t start = 0; start < n; start += FIND_BATCH) {
+        size_t batch = n - start < FIND_BATCH ? n - start : FIND_BATCH;
+        for (size_t i = 0; i < batch; i++) {
+            hashes[i] = hashID(ids[start + i], seed);
+            __builtin_prefetch(&pilots[bucketOf(hashes[i])]);
+        }
+        for (size_t i = 0; i < batch; i++) {
+            positions[i] = position(hashes[i]);
+            __builtin_prefetch(&students[positions[i]]);
+        }
+        for (size_t i = 0; i < batch; i++) {
+            Student& student = students[positions[i]];
+            out[start + i] = student.getID() == ids[start + i] ? &student : NULL;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//implementation file for the GPA column
+
+#include "GpaColumn.h"
+#include <cmath>
+#include <cfloat>
+#ifdef __SSE2__
+#include <emmintrin.h> //same as the flat table, SSE2 is on every x86-64 cpu, anything else falls back to one at a time
+#endif
+using namespace std;
+
+GpaColumn::GpaColumn() {
+    clear();
+}
+
+size_t GpaColumn::add(int id, float gpa) {
+    gpas.push_back(gpa);
+    ids.push_back(id);
+    sum += gpa;
+    sumSquares += (double)gpa * gpa;
+    if (!extremesStale) { //if they're stale they'll get found with a scan anyway
+        low = gpa < low ? gpa : low;
+        high = gpa > high ? gpa : high;
+    }
+    return gpas.size() - 1;
+}
+
+int GpaColumn::remove(size_t row) {
+    float gpa = gpas[row];
+    int removed = ids[row];
+    sum -= gpa;
+    sumSquares -= (double)gpa * gpa;
+    if (gpa == low || gpa == high) { //someone else could have the same one, but we can't know without looking
+        extremesStale = true;
+    }
+    gpas[row] = gpas.back(); //the last row fills the hole
+    ids[row] = ids.back();
+    gpas.pop_back();
+    ids.pop_back();
+    if (gpas.empty()) { //start over clean, so rounding errors from all the adding and subtracting don't pile up forever
+        clear();
+    }
+    return row < ids.size() ? ids[row] : removed;
+}
+
+void GpaColumn::clear() {
+    gpas.clear();
+    ids.clear();
+    sum = 0;
+    sumSquares = 0;
+    low = FLT_MAX;
+    high = -FLT_MAX;
+    extremesStale = false;
+}
+
+void GpaColumn::reserve(size_t rows) {
+    gpas.reserve(rows);
+    ids.reserve(rows);
+}
+
+double GpaColumn::variance() const {
+    if (gpas.empty()) {
+        return 0;
+    }
+    double mean = sum / gpas.size();
+    double result = sumSquares / gpas.size() - mean * mean;
+    return result > 0 ? result : 0; //rounding can push a variance of 0 just below it
+}
+
+float GpaColumn::lowest() const {
+    if (extremesStale) {
+        findExtremes();
+    }
+    return gpas.empty() ? 0 : low;
+}
+
+float GpaColumn::highest() const {
+    if (extremesStale) {
+        findExtremes();
+    }
+    return gpas.empty() ? 0 : high;
+}
+
+void GpaColumn::findExtremes() const {
+    const float* column = gpas.data();
+    size_t n = gpas.size();
+    size_t i = 0;
+    low = FLT_MAX;
+    high = -FLT_MAX;
+#ifdef __SSE2__
+    __m128 lows = _mm_set1_ps(FLT_MAX);
+    __m128 highs = _mm_set1_ps(-FLT_MAX);
+    for (; i + 4 <= n; i += 4) { //4 GPAs at a time
+        __m128 four = _mm_loadu_ps(column + i);
+        lows = _mm_min_ps(lows, four);
+        highs = _mm_max_ps(highs, four);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, lows);
+    for (float lane : lanes) {
+        low = lane < low ? lane : low;
+    }
+    _mm_storeu_ps(lanes, highs);
+    for (float lane : lanes) {
+        high = lane > high ? lane : high;
+    }
+#endif
+    for (; i < n; i++) { //whatever's left over that didn't make a group of 4
+        low = column[i] < low ? column[i] : low;
+        high = column[i] > high ? column[i] : high;
+    }
+    extremesStale = false;
+}
+
+double GpaColumn::sumBetween(float lowGpa, float highGpa, size_t& matched) const {
+    const float* column = gpas.data();
+    size_t n = gpas.size();
+    size_t i = 0;
+    double total = 0;
+    matched = 0;
+#ifdef __SSE2__
+    __m128 lows = _mm_set1_ps(lowGpa);
+    __m128 highs = _mm_set1_ps(highGpa);
+    __m128d sums = _mm_setzero_pd(); //the sums are kept in doubles, two per register, so they don't lose precision
+    __m128d moreSums = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m128 four = _mm_loadu_ps(column + i);
+        __m128 inside = _mm_and_ps(_mm_cmpge_ps(four, lows), _mm_cmple_ps(four, highs)); //all ones in the lanes that are in range
+        __m128 kept = _mm_and_ps(four, inside); //the ones out of range become 0 so they don't add anything
+        sums = _mm_add_pd(sums, _mm_cvtps_pd(kept)); //the bottom two lanes
+        moreSums = _mm_add_pd(moreSums, _mm_cvtps_pd(_mm_movehl_ps(kept, kept))); //and the top two
+        matched += __builtin_popcount(_mm_movemask_ps(inside)); //one bit per lane that was in range
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sums, moreSums));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        if (column[i] >= lowGpa && column[i] <= highGpa) {
+            total += column[i];
+            matched++;
+        }
+    }
+    return total;
+}
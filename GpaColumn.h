@@ -0,0 +1,50 @@
+//header file for the GPA column, every student's GPA copied into one contiguous array next to their ID, so anything that only needs the GPAs
+//can scan them 4 at a time with SIMD instead of walking the table and following two pointers per student. It also keeps running aggregates
+//(count, sum, sum of squares, lowest and highest) that get updated on every add and remove, so the plain average is O(1).
+//Removing moves the last row into the removed one so the column never has holes, which means whoever owns it has to tell the moved student
+//their new row (see StudentTable)
+
+#ifndef GPA_COLUMN
+#define GPA_COLUMN
+
+#include <cstddef>
+#include <vector>
+
+class GpaColumn {
+public:
+    GpaColumn();
+
+    size_t add(int id, float gpa); //adds a row at the end and returns which row it is
+    //removes the row by moving the last row into it, and returns the ID of the student that got moved (the removed ID if it was the last row)
+    int remove(size_t row);
+    void clear();
+    void reserve(size_t rows);
+
+    size_t size() const {
+        return gpas.size();
+    }
+    double average() const { //O(1), from the running sum
+        return gpas.empty() ? 0 : sum / gpas.size();
+    }
+    double variance() const; //O(1) too, the population variance from the running sums
+    float lowest() const; //O(1) unless the lowest one got removed since we last looked, then it's a scan
+    float highest() const;
+
+    //adds up every GPA from low to high (inclusive) with one SIMD scan of the column, and counts how many there were
+    double sumBetween(float low, float high, size_t& matched) const;
+
+    size_t bytes() const { //how much memory the column takes up
+        return gpas.capacity() * sizeof(float) + ids.capacity() * sizeof(int);
+    }
+private:
+    void findExtremes() const; //scans the whole column for the lowest and highest
+
+    std::vector<float> gpas;
+    std::vector<int> ids; //which student each row belongs to, so remove can say who moved
+    double sum; //double, since adding up millions of floats in a float would lose the decimals
+    double sumSquares;
+    mutable float low; //mutable since finding them again after a remove happens when someone asks for them
+    mutable float high;
+    mutable bool extremesStale; //whether a remove took away the lowest or highest, so they have to be found again
+};
+#endif
@@ -0,0 +1,669 @@
+//header file for the chained hash table template. Collisions are handled using chaining. The table doubles once it has more nodes than
+//buckets, or early when a chain gets longer than 3 while it's at least half full (a few clustered keys can't blow it up on their own), and
+//halves again once erasing leaves it less than 1/8 full, so the load factor stays between those with plenty of room in between for it not to
+//flip back and forth. It never shrinks below the length it started with or was reserved for. The table length is always a power of two, so
+//the index is just the stored hash masked by the length, and rehashing never has to run the hasher again.
+//The nodes come from a NodePool, so they're allocated in big slabs instead of one new at a time, and a whole table's worth of nodes can be freed at once.
+//Rehashing is incremental: when the table doubles, the old table is kept alive next to the new one, and every insert, find, and erase moves a
+//few of the old table's buckets over, so no single operation has to move every node at once. Until the old table is empty, lookups check both.
+//The hasher and key equality are template parameters, so which ones are used is decided at compile time and nothing gets dispatched at runtime
+//Big batches of keys can be bulk inserted on multiple threads, see bulkInsert. The table keeps TableStats on its hot paths for the STATS command,
+//which compile down to nothing when they're turned off. (no .cpp because templates have to be in headers)
+
+#ifndef HASH_TABLE
+#define HASH_TABLE
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <cstring>
+#include <new>
+#include <atomic>
+#include <vector>
+#include "Node.h"
+#include "NodePool.h"
+#include "Parallel.h"
+#include "Cursor.h"
+#include "Stats.h"
+
+template <class K, class V, class Hasher, class KeyEqual = std::equal_to<K> >
+class HashTable {
+public:
+    typedef uint64_t hash_type; //what the hasher makes, which gets stored in the nodes
+    typedef Node<K, V> node_type;
+    typedef Hasher hasher_type;
+
+    static const size_t MIGRATE_NODES = 4; //the most nodes each operation moves from the old table to the new one while resizing
+    static const size_t MIGRATE_VISITS = 256; //the most empty old buckets each operation skips past, since most buckets are empty that's usually where the time goes
+    static const size_t BULK_PER_THREAD = 16384; //the fewest keys worth giving their own thread in a bulk insert
+    static const size_t MAX_LOAD_PERCENT = 100; //doubles once there's more nodes than this percent of the buckets
+    static const size_t CHAIN_LOAD_PERCENT = 50; //a chain longer than 3 only doubles the table if it's at least this full
+    static const size_t MIN_LOAD_PERCENT = 12; //halves once erasing leaves it less full than this (about 1/8), down to half full
+    static const size_t FIND_BATCH = 16; //how many keys findMany walks at once, enough cache misses in flight to cover a trip to memory
+
+    //iterates through the old table (if we're in the middle of resizing) and then the table, through any chains it finds, dereferences to the value
+    class iterator {
+    public:
+        iterator(HashTable* _owner, bool _old, size_t _index) : owner(_owner), old(_old), index(_index), node(NULL) {
+            skipEmpty();
+        }
+        V& operator*() {
+            return node->getValue();
+        }
+        V* operator->() {
+            return &node->getValue();
+        }
+        const K& key() { //the key of the current node, since dereferencing gives the value
+            return node->getKey();
+        }
+        hash_type hash() { //the stored hash of the current node, so whoever is iterating doesn't have to hash the key again
+            return node->getHash();
+        }
+        iterator& operator++() { //go to the next node in the chain, or the start of the next chain if this one is over
+            node = node->getNext();
+            if (node == NULL) {
+                index++;
+                skipEmpty();
+            }
+            return *this;
+        }
+        bool operator==(const iterator& other) const {
+            return node == other.node;
+        }
+        bool operator!=(const iterator& other) const {
+            return node != other.node;
+        }
+    private:
+        void skipEmpty() { //moves forward through the tables until we land on a node or go off the end
+            while (node == NULL) {
+                node_type** from = old ? owner->oldTable : owner->table;
+                size_t len = old ? owner->oldLen : owner->tablelen;
+                for (; index < len; index++) {
+                    node = from[index];
+                    if (node != NULL) {
+                        return;
+                    }
+                }
+                if (!old) { //went off the end of the table, so we're done
+                    return;
+                }
+                old = false; //went off the end of the old table, so continue in the new one
+                index = 0;
+            }
+        }
+        HashTable* owner;
+        bool old; //whether we're still going through the old table
+        size_t index; //the bucket the current node is in
+        node_type* node; //the current node, NULL once we're past the end
+    };
+
+    HashTable(size_t _tablelen = 128) : oldTable(NULL), oldLen(0), migrateIndex(0), growAgain(false), tablelen(1), count(0), shrinking(true) { //creates an empty table with at least the given amount of buckets
+        while (tablelen < _tablelen) { //rounded up to a power of two so we can mask instead of modulo
+            tablelen *= 2;
+        }
+        minLen = tablelen;
+        table = newBuckets(tablelen);
+        tableStats.sized(tablelen);
+    }
+    ~HashTable() { //deletes all the nodes straight from the pool without going through the table, then the table structure itself
+        pool.destroyAll();
+        free(oldTable);
+        free(table);
+    }
+    HashTable(const HashTable&) = delete; //the table owns its nodes, so copying it would delete them twice
+    HashTable& operator=(const HashTable&) = delete;
+
+    //hashes the given key, public so callers can hash once and reuse it for both find and insert
+    hash_type hash(const K& key) const {
+        if (!tableStats.sampleHash()) { //almost always, only every so often a hash gets timed
+            return hasher(key);
+        }
+        TableStats::Timer timer(true);
+        hash_type keyHash = hasher(key);
+        tableStats.hashed(timer);
+        return keyHash;
+    }
+    void hash(const K* keys, size_t n, hash_type* out) const { //hashes n keys at once, which some hashers can do faster than one at a time
+        if (!tableStats.sampleHash()) {
+            hasher(keys, n, out);
+            return;
+        }
+        TableStats::Timer timer(true);
+        hasher(keys, n, out);
+        tableStats.hashed(timer, n);
+    }
+
+    //inserts the key and value, returns false without inserting if the key is already in the table
+    bool insert(const K& key, const V& value) {
+        return insert(key, value, hash(key));
+    }
+    bool insert(const K& key, const V& value, hash_type keyHash) {
+        TableStats::Timer timer(tableStats.sampleInsert());
+        migrate(MIGRATE_NODES, MIGRATE_VISITS);
+        if (findNode(key, keyHash) != NULL) { //no repeating keys, because that would cause infinite rehashing (since upon reaching 3 collisisons, the same 4 nodes would be rehashed into the same bucket again)
+            return false;
+        }
+        count++;
+        TableStats::Timer allocTimer(timer.running());
+        node_type* node = pool.create(key, value, keyHash);
+        tableStats.allocated(allocTimer);
+        //place the node, and if that made a chain longer than 3 nodes or the table too full, we rehash the hash table!
+        bool longChain = placeNode(node, table, deHash(keyHash, tablelen));
+        if (resizing()) { //we're already resizing, so whether to double again gets checked once that's done
+            growAgain = growAgain || longChain;
+        } else {
+            resizeTo(grownLength(longChain));
+        }
+        tableStats.inserted(timer);
+        return true;
+    }
+
+    //returns the value associated with the given key, or NULL if the key isn't in the table
+    V* find(const K& key) {
+        return find(key, hash(key));
+    }
+    V* find(const K& key, hash_type keyHash) {
+        migrate(MIGRATE_NODES, MIGRATE_VISITS);
+        node_type* node = findNode(key, keyHash);
+        return node == NULL ? NULL : &node->getValue();
+    }
+    //finds n keys at once, out[i] is the value of keys[i] or NULL. One find at a time is a chain of loads that each wait on the one before
+    //(the bucket, then the node, then the next node), and on a table bigger than the cache every one of them is a trip to memory. So the keys
+    //go FIND_BATCH at a time: they all get hashed, all their buckets get prefetched, and then their chains get walked side by side, one node
+    //of each per round with the next ones prefetched, so all their cache misses are waited on at the same time instead of one after another
+    void findMany(const K* keys, size_t n, V** out) {
+        hash_type hashes[FIND_BATCH];
+        for (size_t start = 0; start < n; start += FIND_BATCH) {
+            size_t batch = n - start < FIND_BATCH ? n - start : FIND_BATCH;
+            migrate(MIGRATE_NODES, MIGRATE_VISITS); //every batch does its share of the resize, like a find would
+            hash(keys + start, batch, hashes);
+            findBatch(keys + start, hashes, batch, out + start);
+        }
+    }
+
+    //deletes the node with the given key, returns false if there was no such key
+    bool erase(const K& key) {
+        return erase(key, hash(key));
+    }
+    bool erase(const K& key, hash_type keyHash) {
+        migrate(MIGRATE_NODES, MIGRATE_VISITS);
+        //if we're resizing, the node might not have been moved over yet
+        if (!unlinkNode(key, table, deHash(keyHash, tablelen)) && !(resizing() && unlinkNode(key, oldTable, deHash(keyHash, oldLen)))) {
+            return false;
+        }
+        count--;
+        tableStats.erased();
+        if (!resizing()) { //otherwise the next erase after the resize checks
+            resizeTo(shrunkLength());
+        }
+        return true;
+    }
+
+    //inserts n keys at once, spread over the given amount of threads, and returns how many were actually inserted. make(i) gets called to
+    //build the value for keys[i], on whichever thread links that key, so it has to be safe to call from several threads at once. Keys that
+    //are already in the table (or earlier in keys) are skipped without calling make, so make gets called exactly once for every key inserted.
+    //The table is presized for everything up front, then the threads hash their share of the keys and sort them by which part of the table
+    //they land in, and then every thread links the nodes of its own parts of the table. No two threads ever touch the same bucket, so there's
+    //no locking, and there's no resize checking either: the table already has room for everything, so the chains stay short
+    template <class Make>
+    size_t bulkInsert(const K* keys, size_t n, Make make, unsigned threads = defaultThreads()) {
+        return bulkInsert(keys, (const hash_type*)NULL, n, make, threads);
+    }
+    //same thing, but if keyHashes isn't NULL the keys are already hashed (like when loading a snapshot) and only get linked
+    template <class Make>
+    size_t bulkInsert(const K* keys, const hash_type* keyHashes, size_t n, Make make, unsigned threads = defaultThreads()) {
+        growFor(count + n); //room for all of them, and all the old nodes moved over so there's only the one table to link into. Not reserve,
+                            //since that would stop the table from ever shrinking back down once they're deleted
+        finishResize();
+        if (threads == 0 || threads > n / BULK_PER_THREAD) { //threads that only get a handful of keys cost more to start than they save
+            threads = n / BULK_PER_THREAD + 1;
+        }
+        size_t parts = 1; //the table is split into parts, a few per thread so a thread that got unlucky with a big part doesn't hold everyone up
+        while (parts < threads * 4 && parts < tablelen) {
+            parts *= 2;
+        }
+        size_t shift = 0; //the part is the top bits of the index, so each part is one contiguous run of buckets
+        while ((tablelen >> shift) > parts) {
+            shift++;
+        }
+
+        //hash every key (unless they came hashed) and count how many go into each part, per thread
+        std::vector<hash_type> computed(keyHashes == NULL ? n : 0);
+        const hash_type* hashes = keyHashes == NULL ? computed.data() : keyHashes;
+        std::vector<size_t> counts(threads * parts, 0); //counts[t * parts + p] is how many of thread t's keys go in part p
+        parallelFor(n, threads, [&](size_t begin, size_t end, unsigned t) {
+            const size_t BATCH = 256; //hashed in batches so a batching hasher doesn't need a buffer the size of the whole chunk
+            for (size_t i = begin; i < end && keyHashes == NULL; i += BATCH) {
+                hasher(keys + i, end - i < BATCH ? end - i : BATCH, computed.data() + i);
+            }
+            for (size_t i = begin; i < end; i++) {
+                counts[t * parts + (deHash(hashes[i], tablelen) >> shift)]++;
+            }
+        });
+
+        //add up the counts so every part gets its own run of the order array, and within it every thread gets its own spot to write into
+        std::vector<size_t> partStart(parts + 1, 0);
+        std::vector<size_t> offsets(threads * parts);
+        size_t running = 0;
+        for (size_t p = 0; p < parts; p++) {
+            partStart[p] = running;
+            for (unsigned t = 0; t < threads; t++) {
+                offsets[t * parts + p] = running;
+                running += counts[t * parts + p];
+            }
+        }
+        partStart[parts] = running;
+
+        //sort the keys by part, every thread goes through the same keys as before so the counts line up
+        std::vector<size_t> order(n); //the indices of the keys, grouped by part
+        parallelFor(n, threads, [&](size_t begin, size_t end, unsigned t) {
+            for (size_t i = begin; i < end; i++) {
+                order[offsets[t * parts + (deHash(hashes[i], tablelen) >> shift)]++] = i;
+            }
+        });
+
+        //the pool isn't thread safe, so all the spots for the nodes get handed out here first, and the threads only construct into them
+        std::vector<node_type*> spots(n);
+        for (size_t k = 0; k < n; k++) {
+            spots[k] = pool.allocate();
+        }
+
+        //every thread grabs the next part nobody has linked yet until there's none left
+        std::atomic<size_t> nextPart(0);
+        std::vector<size_t> inserted(threads, 0);
+        std::vector<std::vector<node_type*> > unused(threads); //spots of keys that were skipped, given back to the pool afterwards
+        parallelFor(threads, threads, [&](size_t, size_t, unsigned t) {
+            for (size_t p = nextPart++; p < parts; p = nextPart++) {
+                for (size_t k = partStart[p]; k < partStart[p + 1]; k++) {
+                    size_t i = order[k];
+                    size_t index = deHash(hashes[i], tablelen);
+                    bool taken = false;
+                    for (node_type* current = table[index]; current != NULL && !taken; current = current->getNext()) {
+                        taken = equal(current->getKey(), keys[i]);
+                    }
+                    if (taken) {
+                        unused[t].push_back(spots[k]);
+                        continue;
+                    }
+                    node_type* node = new (spots[k]) node_type(keys[i], make(i), hashes[i]);
+                    node->setNext(table[index]); //goes on the front of the chain, so there's no walking to the end
+                    table[index] = node;
+                    inserted[t]++;
+                }
+            }
+        });
+
+        size_t total = 0;
+        for (unsigned t = 0; t < threads; t++) {
+            for (node_type* spot : unused[t]) {
+                pool.deallocate(spot);
+            }
+            total += inserted[t];
+        }
+        count += total;
+        tableStats.bulkInserted(total);
+        return total;
+    }
+
+    //presizes the table for the given amount of entries, so inserting that many doesn't keep doubling it, and it doesn't shrink below that
+    //again either, even if they all get erased
+    void reserve(size_t entries) {
+        while (minLen * MAX_LOAD_PERCENT < entries * 100) {
+            minLen *= 2;
+        }
+        growFor(entries);
+    }
+
+    //moves every node that's still in the old table over, so the table is back to being one table
+    void finishResize() {
+        while (resizing()) {
+            migrate(SIZE_MAX, SIZE_MAX);
+        }
+    }
+
+    //deletes every node and goes back to the length the table started with (or was reserved for)
+    void clear() {
+        pool.destroyAll(); //deletes every node at once, from both tables if we're resizing
+        if (resizing()) {
+            free(oldTable);
+            oldTable = NULL;
+            growAgain = false;
+            tableStats.resizeDone();
+        }
+        if (tablelen != minLen) {
+            tableStats.reclaimed((tablelen - minLen) * sizeof(node_type*));
+            free(table);
+            tablelen = minLen;
+            table = newBuckets(tablelen);
+        } else {
+            memset(table, 0, tablelen * sizeof(node_type*)); //empties the buckets
+        }
+        count = 0;
+    }
+
+    size_t size() const { //how many entries are in the table
+        return count;
+    }
+    bool empty() const { //whether there's no entries in the table
+        return count == 0;
+    }
+    bool resizing() const { //whether some nodes are still in the old table
+        return oldTable != NULL;
+    }
+    size_t nodeSlabs() const { //how many slabs the nodes have been allocated in
+        return pool.slabCount();
+    }
+    size_t bucketCount() const { //the length of the table
+        return tablelen;
+    }
+    size_t bucketSize(size_t index) const { //how long the chain in the given bucket is
+        size_t length = 0;
+        for (node_type* current = table[index]; current != NULL; current = current->getNext()) {
+            length++;
+        }
+        return length;
+    }
+
+    size_t bytes() const { //how much memory the table takes up: the node slabs and the bucket arrays
+        return pool.bytes() + (tablelen + (resizing() ? oldLen : 0)) * sizeof(node_type*);
+    }
+    const TableStats& stats() const {
+        return tableStats;
+    }
+    TableShape shape() const { //walks every bucket (of both tables while resizing) to see how long the chains are
+        TableShape result;
+        result.entries = count;
+        result.slots = tablelen + (resizing() ? oldLen : 0);
+        result.bytes = bytes();
+        result.lengthName = "chain";
+        result.lengths.assign(TableStats::BINS, 0);
+        for (int old = 0; old < (resizing() ? 2 : 1); old++) {
+            node_type** buckets = old ? oldTable : table;
+            size_t len = old ? oldLen : tablelen;
+            for (size_t i = 0; i < len; i++) {
+                size_t length = 0;
+                for (node_type* current = buckets[i]; current != NULL; current = current->getNext()) {
+                    length++;
+                }
+                result.lengths[length < TableStats::BINS ? length : TableStats::BINS - 1]++;
+            }
+        }
+        return result;
+    }
+
+    iterator begin() {
+        return iterator(this, resizing(), 0);
+    }
+    iterator end() {
+        return iterator(this, false, tablelen);
+    }
+
+    //calls visit(key, value, hash) on every node of the buckets from the cursor on (in the cursor's reverse bit order, see Cursor.h) until at
+    //least limit nodes were visited or the table ran out, and returns the cursor to continue from next time, 0 once the whole table is done.
+    //Start with 0. Every node that's in the table for the whole scan gets visited at least once, even if the table resizes between calls.
+    //While resizing, the bucket of the smaller table gets scanned along with every bucket of the bigger table that it splits into, since a
+    //node can be in either. It doesn't move any nodes over itself, so visit can't change the table
+    template <class Visit>
+    size_t scan(size_t cursor, size_t limit, Visit visit) {
+        size_t visited = 0;
+        do {
+            if (!resizing()) {
+                visited += visitChain(table[cursor & (tablelen - 1)], visit);
+                cursor = nextCursor(cursor, tablelen - 1);
+                continue;
+            }
+            bool oldSmaller = oldLen < tablelen;
+            node_type** small = oldSmaller ? oldTable : table;
+            node_type** big = oldSmaller ? table : oldTable;
+            size_t smallMask = (oldSmaller ? oldLen : tablelen) - 1;
+            size_t bigMask = (oldSmaller ? tablelen : oldLen) - 1;
+            visited += visitChain(small[cursor & smallMask], visit);
+            do { //the buckets of the bigger table are the small one's bucket with every combination of the extra bits on top
+                visited += visitChain(big[cursor & bigMask], visit);
+                cursor = nextCursor(cursor, bigMask);
+            } while (cursor & (smallMask ^ bigMask));
+        } while (cursor != 0 && visited < limit);
+        return cursor;
+    }
+    //whether a scan that's at the cursor (and didn't start over at 0 since) already went past the bucket of the node with the given hash. The
+    //bucket is the bottom bits of the hash, and those come first in reverse order, so the whole hash can be compared whatever the length is
+    static bool scanned(size_t cursor, hash_type keyHash) {
+        return reverseBits(keyHash) < reverseBits(cursor);
+    }
+    //turns shrinking on erase off (or back on), since a scan going on while the table halves can visit some nodes twice (see Cursor.h)
+    void setShrinking(bool on) {
+        shrinking = on;
+    }
+private:
+    template <class Visit>
+    static size_t visitChain(node_type* node, Visit& visit) { //visits every node of the chain and returns how many there were
+        size_t visited = 0;
+        for (; node != NULL; node = node->getNext(), visited++) {
+            visit(node->getKey(), node->getValue(), node->getHash());
+        }
+        return visited;
+    }
+
+    //get an index in the hash table based on the given hash and table length
+    static size_t deHash(hash_type keyHash, size_t len) {
+        return keyHash & (len - 1); //len is a power of two, so masking the hash with len-1 keeps it within bounds, same as a modulo but way cheaper
+    }
+
+    //makes a new table of empty buckets. calloc instead of new[]() because for big tables the OS hands over memory that's already zeroed, so we
+    //don't have to touch every bucket up front (which would be a stop-the-world pause of its own)
+    static node_type** newBuckets(size_t len) {
+        node_type** buckets = static_cast<node_type**>(calloc(len, sizeof(node_type*)));
+        if (buckets == NULL) {
+            throw std::bad_alloc();
+        }
+        return buckets;
+    }
+
+    //place the node into the hash table at the given index and return true if we need to rehash, based on chain length
+    static bool placeNode(node_type* node, node_type** into, size_t index) {
+        if (into[index] == NULL) { //if the bucket at the given index is empty, the node just goes there
+            into[index] = node;
+            return false; //no need to rehash because the chain length is 1 guaranteed!
+        }
+        node_type* current = into[index]; //finds the beginning node
+        int chainlen = 2; //how long the chain is, starts at 2 because it includes the first and (new) last nodes
+        for (; current->getNext() != NULL;) { //iterate through the chain until we reach the last node
+            current = current->getNext(); //go to the next node
+            chainlen++; //increment the chain length since we checked one more node
+        }
+        current->setNext(node); //places the node after the previous last node
+        return chainlen > 3; //if the chain length exceeds 3, we say to rehash
+    }
+
+    //findMany for up to FIND_BATCH keys that are already hashed
+    void findBatch(const K* keys, const hash_type* hashes, size_t n, V** out) {
+        node_type** buckets[FIND_BATCH];
+        for (size_t i = 0; i < n; i++) { //the buckets first, the loads can't start until the addresses are known anyway
+            buckets[i] = &table[deHash(hashes[i], tablelen)];
+            __builtin_prefetch(buckets[i]);
+        }
+        node_type* current[FIND_BATCH];
+        size_t probes[FIND_BATCH];
+        size_t walking[FIND_BATCH]; //the keys whose chains aren't done yet
+        size_t left = 0;
+        for (size_t i = 0; i < n; i++) { //by the time we get back around to the first bucket it's had time to arrive
+            current[i] = *buckets[i];
+            probes[i] = 0;
+            out[i] = NULL;
+            if (current[i] != NULL) {
+                __builtin_prefetch(current[i]);
+                walking[left++] = i;
+            }
+        }
+        while (left > 0) { //one node of every chain per round, and the next node gets prefetched for the round after
+            size_t stillWalking = 0;
+            for (size_t w = 0; w < left; w++) {
+                size_t i = walking[w];
+                node_type* node = current[i];
+                probes[i]++;
+                if (equal(node->getKey(), keys[i])) {
+                    out[i] = &node->getValue();
+                    continue;
+                }
+                current[i] = node->getNext();
+                if (current[i] != NULL) {
+                    __builtin_prefetch(current[i]);
+                    walking[stillWalking++] = i;
+                }
+            }
+            left = stillWalking;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (out[i] == NULL && resizing()) { //the old table only matters while resizing, which doesn't last long, so it's walked the usual way
+                for (node_type* node = oldTable[deHash(hashes[i], oldLen)]; node != NULL; node = node->getNext()) {
+                    probes[i]++;
+                    if (equal(node->getKey(), keys[i])) {
+                        out[i] = &node->getValue();
+                        break;
+                    }
+                }
+            }
+            tableStats.lookup(probes[i]);
+        }
+    }
+
+    //looks for the node with the given key in the table, and in the old table if it hasn't been moved over yet
+    node_type* findNode(const K& key, hash_type keyHash) {
+        size_t probes = 0; //how many nodes we looked at, for the stats
+        //iterates through the chain at the key's index and goes to the next one each iteration until it meets a null node, that being the end
+        for (node_type* current = table[deHash(keyHash, tablelen)]; current != NULL; current = current->getNext()) {
+            probes++;
+            if (equal(current->getKey(), key)) {
+                tableStats.lookup(probes);
+                return current;
+            }
+        }
+        if (resizing()) { //same thing in the old table
+            for (node_type* current = oldTable[deHash(keyHash, oldLen)]; current != NULL; current = current->getNext()) {
+                probes++;
+                if (equal(current->getKey(), key)) {
+                    tableStats.lookup(probes);
+                    return current;
+                }
+            }
+        }
+        tableStats.lookup(probes);
+        return NULL;
+    }
+
+    //deletes the node with the given key from the chain at the given index of the given table, returns false if it isn't there
+    bool unlinkNode(const K& key, node_type** from, size_t index) {
+        node_type* previous = NULL; //we store the previous node so we can bridge the gap created by deleting middle or end nodes
+        //check the chain starting from the index position in the table, continue until going off the end of the chain (entering NULL territory)
+        for (node_type* current = from[index]; current != NULL; current = current->getNext()) {
+            if (equal(current->getKey(), key)) { //delete the node if its key matches
+                if (previous == NULL) { //if it's the first one in the chain, update the table by bringing the next node into the table at the index
+                    from[index] = current->getNext();
+                } else { //if it's the middle or end one, bridge the gap by setting previous's next to the deleted node's next (1 -> 2 -> 3)  ==>  (1 ->   -> 3)  ==>  (1 -> 3)
+                    previous->setNext(current->getNext());
+                }
+                pool.destroy(current);
+                return true;
+            }
+            previous = current; //updates previous, because the next current's previous is going to be current
+        }
+        return false;
+    }
+
+    //the length the table should double to if it's too full (tablelen if it isn't), longChain is whether a chain got longer than 3
+    size_t grownLength(bool longChain) const {
+        bool full = count * 100 > tablelen * MAX_LOAD_PERCENT || (longChain && count * 100 >= tablelen * CHAIN_LOAD_PERCENT);
+        return full ? tablelen * 2 : tablelen;
+    }
+    //the length the table should halve down to if it's too empty (tablelen if it isn't). Only erases check this, so an empty table that
+    //just got presized for a bulk insert doesn't shrink right back before the nodes go in
+    size_t shrunkLength() const {
+        size_t newlen = tablelen;
+        if (shrinking && count * 100 < tablelen * MIN_LOAD_PERCENT) { //halved until it's about half full, which is a long way from either limit
+            while (newlen / 2 >= minLen && count * 2 <= newlen / 2) {
+                newlen /= 2;
+            }
+        }
+        return newlen;
+    }
+    void resizeTo(size_t newlen) { //starts resizing, unless it's already that length
+        if (newlen != tablelen) {
+            tableStats.resizeStarted();
+            startResize(newlen);
+        }
+    }
+    //makes sure the table has room for the given amount of entries, so inserting that many doesn't keep doubling the table
+    void growFor(size_t entries) {
+        finishResize(); //finish any resize that's going on first so we only have one old table at a time
+        size_t newlen = tablelen;
+        while (newlen * MAX_LOAD_PERCENT < entries * 100) {
+            newlen *= 2;
+        }
+        resizeTo(newlen); //the nodes get moved over bit by bit like any other resize
+    }
+
+    //starts resizing to the given length: the current table becomes the old table, and a new empty one takes its place. Shrinking works
+    //exactly the same way, the nodes of two old buckets just end up in the same new one
+    void startResize(size_t newlen) {
+        oldTable = table;
+        oldLen = tablelen;
+        migrateIndex = 0;
+        growAgain = false;
+        for (size_t len = tablelen; len < newlen; len *= 2) { //reserve can go up more than one doubling at once
+            tableStats.doubled();
+        }
+        for (size_t len = tablelen; len > newlen; len /= 2) { //and shrinking can go down more than one halving
+            tableStats.halved();
+        }
+        if (newlen < tablelen) { //the old table gets freed once it's empty
+            tableStats.reclaimed((tablelen - newlen) * sizeof(node_type*));
+        }
+        tablelen = newlen; //the new length of the hash table
+        table = newBuckets(tablelen); //the new shiny hash table
+        tableStats.sized(tablelen);
+    }
+
+    //moves up to maxNodes nodes from the old table into the new one, skipping at most maxVisits empty buckets along the way
+    void migrate(size_t maxNodes, size_t maxVisits) {
+        while (resizing() && maxNodes > 0 && maxVisits > 0) {
+            node_type* node = oldTable[migrateIndex];
+            if (node == NULL) { //nothing (left) in this bucket, go to the next
+                migrateIndex++;
+                maxVisits--;
+            } else { //take the first node off the chain and put it where it goes in the new table
+                oldTable[migrateIndex] = node->getNext();
+                node->setNext(NULL);
+                if (placeNode(node, table, deHash(node->getHash(), tablelen))) { //if we detect too long a chain, we might have to double again once this resize is done
+                    growAgain = true;
+                }
+                maxNodes--;
+            }
+            if (migrateIndex == oldLen) { //the old table is empty, so the resize is done
+                free(oldTable); //deletes the old hash table
+                oldTable = NULL;
+                size_t newlen = grownLength(growAgain); //the inserts while resizing might have made it too full again
+                if (newlen != tablelen) {
+                    startResize(newlen);
+                } else {
+                    tableStats.resizeDone();
+                }
+            }
+        }
+    }
+
+    NodePool<node_type> pool; //where all the nodes are allocated
+    node_type** oldTable; //the table we're moving nodes out of while resizing, NULL when we aren't resizing
+    size_t oldLen; //the length of the old table
+    size_t migrateIndex; //the next bucket of the old table to move nodes out of, everything before it is empty
+    bool growAgain; //whether a chain got too long during the current resize, so we might double again once it's done
+    node_type** table; //the hash table of linked list chains
+    size_t tablelen; //the length of the hash table which gets doubled when it's too full and halved when it's too empty
+    size_t minLen; //the length it never shrinks below, the starting length or whatever reserve asked for
+    size_t count; //how many nodes are in the table (both tables if we're resizing)
+    bool shrinking; //whether erases can halve the table, see setShrinking
+    mutable TableStats tableStats; //mutable since hashing is const but still gets timed
+    Hasher hasher;
+    KeyEqual equal;
+};
+#endif
@@ -0,0 +1,75 @@
+//header file for the hash policies that the hash tables can be instantiated with. A hasher needs an operator() that hashes a key into one
+//well-mixed 64-bit hash, and an operator() that hashes an array of keys at once. The tables store that 64-bit hash and just mask it into an index.
+//It also needs a name, which gets saved along with stored hashes (like in snapshots) so we can tell if they came from the same hasher
+
+#ifndef HASHERS
+#define HASHERS
+
+#include <cstdint>
+#include <cstddef>
+#include "SHA3.h"
+
+//hashes integer keys with SHA-3 256, and folds the 32-byte digest down to 64 bits right away so nobody has to keep the whole digest around
+struct SHA3Hasher {
+    static const char* name() {
+        return "sha3";
+    }
+    uint64_t operator()(int key) const {
+        return SHA3::Fold(SHA3::HashFixed(key)); //the fixed-size path, since we know the key is always an int
+    }
+    static const size_t BATCH = 64; //how many digests get made at a time, in a buffer on the stack so hashing a batch never allocates
+    void operator()(const int* keys, size_t n, uint64_t* out) const { //hashes a bunch of keys with the parallel keccak, way faster than one by one
+        SHA3::digest digests[BATCH];
+        for (size_t start = 0; start < n; start += BATCH) {
+            size_t batch = n - start < BATCH ? n - start : BATCH;
+            SHA3::HashBatch(keys + start, batch, digests);
+            for (size_t i = 0; i < batch; i++) {
+                out[start + i] = SHA3::Fold(digests[i]);
+            }
+        }
+    }
+};
+
+//hashes integer keys wyhash-style: the key is spread over 64 bits and then mixed with a 128-bit multiply whose two halves get xored together,
+//which is way cheaper than 24 keccak rounds but still spreads every input bit across the whole hash. Not cryptographic at all, which is fine for a table
+struct WyHasher {
+    static const char* name() {
+        return "wyhash";
+    }
+    uint64_t operator()(int key) const {
+        uint64_t k = (uint32_t)key;
+        uint64_t a = (k << 32) | k; //wyhash reads short inputs twice into both halves, a 4-byte key is exactly that
+        return mum(0xe7037ed1a0b428dbULL ^ sizeof(key), mum(a ^ 0xe7037ed1a0b428dbULL, a ^ 0xa0761d6478bd642fULL)); //the constants are wyhash's default secret
+    }
+    void operator()(const int* keys, size_t n, uint64_t* out) const { //it's so cheap there's nothing to gain from batching, so just a loop
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (*this)(keys[i]);
+        }
+    }
+private:
+    //multiplies the two into a 128-bit product and xors its halves, the multiply-and-mix that wyhash is built on
+    static uint64_t mum(uint64_t a, uint64_t b) {
+        __uint128_t product = (__uint128_t)a * b;
+        return (uint64_t)product ^ (uint64_t)(product >> 64);
+    }
+};
+
+//hashes integer keys with the splitmix64 finalizer, just a few multiplies and xorshifts. The cheapest hasher here, and since our keys are
+//small sequential ints, good enough that all the bits change when the ID goes up by one
+struct MixHasher {
+    static const char* name() {
+        return "mix";
+    }
+    uint64_t operator()(int key) const {
+        uint64_t x = (uint32_t)key + 0x9e3779b97f4a7c15ULL; //add the golden ratio so 0 doesn't hash to 0
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+    void operator()(const int* keys, size_t n, uint64_t* out) const {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (*this)(keys[i]);
+        }
+    }
+};
+#endif
@@ -0,0 +1,126 @@
+//implementation file for the secondary indexes
+
+#include "Indexes.h"
+#include <algorithm>
+using namespace std;
+
+void NameIndex::add(uint32_t name, int id) {
+    ids[name].push_back(id);
+}
+
+void NameIndex::remove(uint32_t name, int id) {
+    unordered_map<uint32_t, vector<int> >::iterator it = ids.find(name);
+    if (it == ids.end()) {
+        return;
+    }
+    vector<int>& list = it->second;
+    for (size_t i = 0; i < list.size(); i++) { //only walks the people with the same name
+        if (list[i] == id) {
+            list[i] = list.back(); //the order doesn't matter, so the last one fills the hole
+            list.pop_back();
+            break;
+        }
+    }
+    if (list.empty()) { //nobody has the name anymore, so it doesn't need to be kept
+        ids.erase(it);
+    }
+}
+
+const vector<int>* NameIndex::find(uint32_t name) const {
+    unordered_map<uint32_t, vector<int> >::const_iterator it = ids.find(name);
+    return it == ids.end() ? NULL : &it->second;
+}
+
+size_t NameIndex::bytes() const {
+    size_t total = ids.bucket_count() * sizeof(void*);
+    for (const pair<const uint32_t, vector<int> >& name : ids) { //a node per name, with the name and its list of IDs
+        total += sizeof(name) + sizeof(void*) + name.second.capacity() * sizeof(int);
+    }
+    return total;
+}
+
+GpaIndex::GpaIndex() {
+    clear();
+}
+
+void GpaIndex::clear() {
+    blocks.assign(1, vector<Entry>()); //the one empty block, so there's always a block to go into
+    firsts.assign(1, Entry{0, 0});
+    count = 0;
+}
+
+size_t GpaIndex::findBlock(const Entry& entry) const {
+    //the last block whose first entry isn't after this one, or the first block if they all are
+    size_t block = upper_bound(firsts.begin(), firsts.end(), entry) - firsts.begin();
+    return block == 0 ? 0 : block - 1;
+}
+
+size_t GpaIndex::lowerBound(const vector<Entry>& entries, const Entry& entry) {
+    return lower_bound(entries.begin(), entries.end(), entry) - entries.begin();
+}
+
+void GpaIndex::add(float gpa, int id) {
+    Entry entry = {gpa, id};
+    size_t block = findBlock(entry);
+    vector<Entry>& entries = blocks[block];
+    entries.insert(entries.begin() + lowerBound(entries, entry), entry);
+    firsts[block] = entries.front();
+    count++;
+    if (entries.size() > BLOCK) { //too big, so the back half becomes its own block right after it
+        vector<Entry> back(entries.begin() + BLOCK / 2, entries.end());
+        entries.resize(BLOCK / 2);
+        firsts.insert(firsts.begin() + block + 1, back.front());
+        blocks.insert(blocks.begin() + block + 1, move(back)); //only moves the blocks' pointers, not their entries
+    }
+}
+
+void GpaIndex::addMany(vector<Entry>& entries) {
+    if (entries.size() <= count / 4) { //a few (or none), so putting them in one by one is cheaper than redoing everything
+        for (Entry& entry : entries) {
+            add(entry.gpa, entry.id);
+        }
+        return;
+    }
+    entries.reserve(entries.size() + count);
+    for (vector<Entry>& block : blocks) {
+        entries.insert(entries.end(), block.begin(), block.end());
+    }
+    sort(entries.begin(), entries.end());
+    clear();
+    blocks.clear();
+    firsts.clear();
+    for (size_t i = 0; i < entries.size(); i += BLOCK / 2) { //half full, so the next inserts don't split every block right away
+        blocks.emplace_back(entries.begin() + i, entries.begin() + min(i + BLOCK / 2, entries.size()));
+        firsts.push_back(blocks.back().front());
+    }
+    if (blocks.empty()) {
+        clear();
+    }
+    count = entries.size();
+}
+
+void GpaIndex::remove(float gpa, int id) {
+    Entry entry = {gpa, id};
+    size_t block = findBlock(entry);
+    vector<Entry>& entries = blocks[block];
+    size_t i = lowerBound(entries, entry);
+    if (i == entries.size() || entries[i].gpa != gpa || entries[i].id != id) { //not in the index
+        return;
+    }
+    entries.erase(entries.begin() + i);
+    count--;
+    if (!entries.empty()) {
+        firsts[block] = entries.front();
+    } else if (blocks.size() > 1) { //empty blocks go away, except the last one left
+        blocks.erase(blocks.begin() + block);
+        firsts.erase(firsts.begin() + block);
+    }
+}
+
+size_t GpaIndex::bytes() const {
+    size_t total = blocks.capacity() * sizeof(vector<Entry>) + firsts.capacity() * sizeof(Entry);
+    for (const vector<Entry>& block : blocks) {
+        total += block.capacity() * sizeof(Entry);
+    }
+    return total;
+}
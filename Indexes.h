@@ -0,0 +1,76 @@
+//header file for the secondary indexes, the ways to find students other than by their ID. The NameIndex is a hash index from last name (its
+//ID in the name pool) to the IDs of everyone with it, and the GpaIndex keeps every GPA in order, in sorted blocks of a few hundred so a range of GPAs is a binary
+//search and then a walk through the blocks. Both only hold IDs (the students themselves stay in the table), so a query costs about as much as
+//the amount of students it finds instead of walking every student. The StudentTable keeps them in sync with the table when they're turned on
+
+#ifndef INDEXES
+#define INDEXES
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class NameIndex {
+public:
+    void add(uint32_t name, int id);
+    void remove(uint32_t name, int id);
+    void clear() {
+        ids.clear();
+    }
+    const std::vector<int>* find(uint32_t name) const; //the IDs of everyone with that name, NULL if nobody has it
+    size_t bytes() const; //roughly, the map's own nodes aren't visible from outside it
+private:
+    std::unordered_map<uint32_t, std::vector<int> > ids;
+};
+
+class GpaIndex {
+public:
+    struct Entry {
+        float gpa;
+        int id; //ties are in ID order, so every entry has exactly one spot and removing one can binary search for it
+        bool operator<(const Entry& other) const {
+            return gpa < other.gpa || (gpa == other.gpa && id < other.id);
+        }
+    };
+
+    GpaIndex();
+
+    void add(float gpa, int id);
+    void addMany(std::vector<Entry>& entries); //for bulk inserts: sorts them in with everything else at once instead of one at a time
+    void remove(float gpa, int id);
+    void clear();
+    size_t size() const {
+        return count;
+    }
+    size_t bytes() const;
+
+    //calls visit(id) for everyone with a GPA from low to high (inclusive), lowest first, and returns how many there were
+    template <class Visit>
+    size_t between(float low, float high, Visit visit) const {
+        size_t found = 0;
+        size_t block = findBlock(Entry{low, -2147483647 - 1}); //the smallest ID, so it's before every entry with that GPA
+        size_t i = lowerBound(blocks[block], Entry{low, -2147483647 - 1});
+        for (; block < blocks.size(); block++, i = 0) {
+            const std::vector<Entry>& entries = blocks[block];
+            for (; i < entries.size(); i++) {
+                if (entries[i].gpa > high) {
+                    return found;
+                }
+                visit(entries[i].id);
+                found++;
+            }
+        }
+        return found;
+    }
+private:
+    static const size_t BLOCK = 512; //a block that gets bigger than this gets split in half, so inserting into one only moves up to 4 KB around
+
+    size_t findBlock(const Entry& entry) const; //the block the entry is in (or would go in)
+    static size_t lowerBound(const std::vector<Entry>& entries, const Entry& entry);
+
+    std::vector<std::vector<Entry> > blocks; //sorted, and every block's entries come after the block before it. Always at least one block
+    std::vector<Entry> firsts; //the first entry of every block, so finding the block doesn't have to touch the blocks themselves
+    size_t count;
+};
+#endif
@@ -0,0 +1,320 @@
+//implementation file for the journal
+
+#include "Journal.h"
+#include <cstring>
+#include <chrono>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+static const char JOURNAL_MAGIC[8] = {'H', 'A', 'R', 'R', 'Y', 'J', 'L', '\0'}; //the start of every journal file
+static const uint32_t JOURNAL_VERSION = 1;
+static const size_t JOURNAL_HEADER = 16; //the magic, the version, and the generation
+const uint8_t Journal::RECORD_ADD;
+const uint8_t Journal::RECORD_DELETE;
+
+//the FNV-1a hash of the bytes, used as each record's checksum so a record that only got half written can be told apart from a real one
+static uint32_t checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+//adds the raw bytes of the given value onto the end of the record
+template <class T>
+static void put(vector<char>& record, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    record.insert(record.end(), bytes, bytes + sizeof(T));
+}
+
+Journal::Journal(const string& _path, SyncPolicy _policy, unsigned _groupMillis) : path(_path), policy(_policy), groupMillis(_groupMillis), fd(-1),
+    size(0), generation(0), failed(false), compacting(false), stopping(false) {}
+
+Journal::~Journal() { //stops the flusher, waits for the compactor, and then writes and fsyncs whatever is left
+    {
+        lock_guard<mutex> lock(bufferLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+    lock_guard<mutex> lock(fileLock);
+    if (fd >= 0) {
+        writeOut(true);
+        close(fd);
+    }
+}
+
+bool Journal::exists(const string& file) {
+    struct stat info;
+    return stat(file.c_str(), &info) == 0;
+}
+
+bool Journal::open(string& error) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644); //append only, so every write goes on the end even if something else moved the offset
+    if (fd < 0) {
+        error = "couldn't open " + path;
+        return false;
+    }
+    struct stat info;
+    fstat(fd, &info);
+    size = info.st_size;
+    if (size == 0) { //brand new journal, so it needs its header
+        char header[JOURNAL_HEADER] = {0};
+        memcpy(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        memcpy(header + 8, &JOURNAL_VERSION, sizeof(JOURNAL_VERSION));
+        memcpy(header + 12, &generation, sizeof(generation));
+        if (write(fd, header, JOURNAL_HEADER) != (ssize_t)JOURNAL_HEADER || fsync(fd)) {
+            error = "couldn't write to " + path;
+            return false;
+        }
+        size = JOURNAL_HEADER;
+    } else { //make sure we're not about to append to something that isn't a journal
+        char header[JOURNAL_HEADER];
+        uint32_t version = 0;
+        if (pread(fd, header, JOURNAL_HEADER, 0) != (ssize_t)JOURNAL_HEADER || memcmp(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC))) {
+            error = path + " isn't a journal";
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        memcpy(&version, header + 8, sizeof(version));
+        if (version != JOURNAL_VERSION) {
+            error = path + " is from a different version (" + to_string(version) + ")";
+            close(fd);
+            fd = -1;
+            return false;
+        }
+    }
+    if (policy == SYNC_GROUP && !flusher.joinable()) {
+        flusher = thread(&Journal::flushLoop, this);
+    }
+    return true;
+}
+
+void Journal::add(Student& student) {
+    vector<char> record;
+    put(record, (uint32_t)0); //where the checksum goes once the rest is in
+    put(record, RECORD_ADD);
+    put(record, student.getID());
+    put(record, student.getGPA());
+    put(record, (uint32_t)student.getName(0).size());
+    put(record, (uint32_t)student.getName(1).size());
+    record.insert(record.end(), student.getName(0).begin(), student.getName(0).end());
+    record.insert(record.end(), student.getName(1).begin(), student.getName(1).end());
+    uint32_t sum = checksum(record.data() + 4, record.size() - 4);
+    memcpy(record.data(), &sum, sizeof(sum));
+    append(record.data(), record.size());
+}
+
+void Journal::remove(int id) {
+    vector<char> record;
+    put(record, (uint32_t)0);
+    put(record, RECORD_DELETE);
+    put(record, id);
+    uint32_t sum = checksum(record.data() + 4, record.size() - 4);
+    memcpy(record.data(), &sum, sizeof(sum));
+    append(record.data(), record.size());
+}
+
+void Journal::sync() {
+    lock_guard<mutex> lock(fileLock);
+    writeOut(true);
+}
+
+void Journal::append(const char* record, size_t recordSize) {
+    if (policy == SYNC_ALWAYS) { //the record is written and fsynced before we return
+        lock_guard<mutex> file(fileLock);
+        {
+            lock_guard<mutex> lock(bufferLock);
+            buffer.insert(buffer.end(), record, record + recordSize);
+        }
+        writeOut(true);
+        return;
+    }
+    bool full;
+    {
+        lock_guard<mutex> lock(bufferLock);
+        buffer.insert(buffer.end(), record, record + recordSize);
+        full = buffer.size() >= FLUSH_BYTES;
+    }
+    if (full && policy == SYNC_GROUP) { //the flusher writes it, just earlier than it would have
+        wake.notify_one();
+    } else if (full) { //nobody else is going to write it
+        lock_guard<mutex> file(fileLock);
+        writeOut(false);
+    }
+}
+
+void Journal::writeOut(bool syncing) {
+    vector<char> pending;
+    {
+        lock_guard<mutex> lock(bufferLock);
+        pending.swap(buffer); //takes everything waiting so new records can keep coming in while we write
+    }
+    if (fd < 0) {
+        return;
+    }
+    for (size_t written = 0; written < pending.size();) {
+        ssize_t result = write(fd, pending.data() + written, pending.size() - written);
+        if (result < 0) {
+            failed = true;
+            return;
+        }
+        written += result;
+        size += result;
+    }
+    if (syncing && fdatasync(fd)) {
+        failed = true;
+    }
+}
+
+void Journal::flushLoop() { //every groupMillis (or sooner if the buffer fills up), writes and fsyncs everything at once
+    while (true) {
+        {
+            unique_lock<mutex> lock(bufferLock);
+            wake.wait_for(lock, chrono::milliseconds(groupMillis), [this]() {
+                return stopping || buffer.size() >= FLUSH_BYTES;
+            });
+            if (stopping) { //the destructor does the last write
+                return;
+            }
+        }
+        lock_guard<mutex> file(fileLock);
+        writeOut(true);
+    }
+}
+
+void Journal::restart(Snapshot::Columns* columns) {
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+    lock_guard<mutex> file(fileLock);
+    writeOut(true); //everything up to now goes in the journal that's being replaced, which the snapshot has all of
+    if (fd < 0 || failed) {
+        delete columns;
+        return;
+    }
+    close(fd);
+    fd = -1;
+    generation++; //the fresh journal goes on top of the snapshot that's about to be written, not the one before
+    string error;
+    //a fresh journal for everything after the snapshot. The directory gets synced before any change goes into it, otherwise a power loss
+    //could undo the rename and the new journal with it
+    if (rename(path.c_str(), oldPath().c_str()) || !open(error) || !Snapshot::SyncDirectory(path)) {
+        failed = true;
+        delete columns;
+        return;
+    }
+    compacting = true;
+    columns->generation = generation;
+    compactor = thread([this, columns]() {
+        string error;
+        if (Snapshot::Write(snapshotPath(), *columns, error)) { //only returns once the snapshot and its directory are on disk
+            unlink(oldPath().c_str()); //the snapshot has everything the old journal had
+        } else {
+            failed = true; //the old journal stays, so nothing is lost, but we can't compact again
+        }
+        delete columns;
+        compacting = false;
+    });
+}
+
+bool Journal::restartNow(Snapshot::Columns* columns, string& error) {
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+    lock_guard<mutex> file(fileLock);
+    writeOut(true); //everything up to now, which the snapshot has all of
+    columns->generation = ++generation;
+    bool written = Snapshot::Write(snapshotPath(), *columns, error);
+    delete columns;
+    if (!written) {
+        failed = true; //the journals are all still there and still go on top of the last snapshot, but we can't compact again
+        return false;
+    }
+    //the snapshot is on disk with a generation no journal has, so from here on a crash skips the journals and just loads the snapshot
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    unlink(path.c_str());
+    unlink(oldPath().c_str());
+    if (!open(error) || !Snapshot::SyncDirectory(path)) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool Journal::readChanges(const string& file, vector<Change>& changes, uint32_t& generation) {
+    Snapshot::MappedFile journal(file);
+    uint32_t version = 0;
+    if (!journal.ok() || journal.size() < JOURNAL_HEADER || memcmp(journal.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC))) {
+        return false;
+    }
+    memcpy(&version, journal.data() + 8, sizeof(version));
+    if (version != JOURNAL_VERSION) {
+        return false;
+    }
+    memcpy(&generation, journal.data() + 12, sizeof(generation));
+    const char* data = journal.data();
+    size_t end = journal.size();
+    size_t at = JOURNAL_HEADER;
+    size_t good = at; //the end of the last record that was all there
+    while (at < end) { //stops at the first record that's cut off or doesn't match its checksum
+        size_t start = at;
+        uint32_t sum;
+        uint8_t type;
+        if (end - at < 5) {
+            break;
+        }
+        memcpy(&sum, data + at, 4);
+        memcpy(&type, data + at + 4, 1);
+        at += 5;
+        Change change;
+        change.add = type == RECORD_ADD;
+        if (type == RECORD_ADD) {
+            uint32_t firstLength;
+            uint32_t lastLength;
+            if (end - at < 16) {
+                break;
+            }
+            memcpy(&change.id, data + at, 4);
+            memcpy(&change.gpa, data + at + 4, 4);
+            memcpy(&firstLength, data + at + 8, 4);
+            memcpy(&lastLength, data + at + 12, 4);
+            at += 16;
+            if (end - at < (uint64_t)firstLength + lastLength) {
+                break;
+            }
+            change.firstname.assign(data + at, firstLength);
+            change.lastname.assign(data + at + firstLength, lastLength);
+            at += firstLength + lastLength;
+        } else if (type == RECORD_DELETE) {
+            if (end - at < 4) {
+                break;
+            }
+            memcpy(&change.id, data + at, 4);
+            at += 4;
+        } else {
+            break;
+        }
+        if (checksum(data + start + 4, at - start - 4) != sum) {
+            break;
+        }
+        changes.push_back(change);
+        good = at;
+    }
+    if (good < end && truncate(file.c_str(), good)) { //whatever is after the last good record is a torn write, so it goes
+        //if it can't be cut off, the next recovery just stops at the same spot again
+    }
+    return true;
+}
@@ -0,0 +1,172 @@
+//header file for the journal, an append-only file of every change made to the table (every student added and every student deleted) so the
+//database survives the program quitting or crashing. On startup the last snapshot gets loaded and then the journal gets replayed on top of it.
+//Writing every change to disk and waiting for it with fsync is slow, so how often that happens is up to the sync policy: ALWAYS fsyncs every
+//change before returning, GROUP collects changes and a background thread writes and fsyncs them all together every few milliseconds (so a
+//crash can lose at most that many milliseconds of changes), and NEVER leaves it up to the OS.
+//Once the journal gets big it gets compacted: the table is copied into a snapshot and the journal starts over. The snapshot gets written
+//on a background thread, and the old journal is kept until it's done, so a crash in the middle just means replaying a bit more.
+//Every compaction makes a new generation: its snapshot and the journal started with it both have the generation's number in their headers,
+//and a journal only gets replayed on top of the snapshot of its own generation (or on top of the .old it came after, if that compaction never
+//got its snapshot written). LOAD replaces every student without journaling any of them, so its compaction (compactNow) writes the snapshot
+//before starting the journal over, and a crash anywhere in between never replays the changes from before the LOAD on top of what it loaded
+
+#ifndef JOURNAL
+#define JOURNAL
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "Student.h"
+#include "Snapshot.h"
+
+class Journal {
+public:
+    enum SyncPolicy { SYNC_ALWAYS, SYNC_GROUP, SYNC_NEVER };
+    static const size_t COMPACT_BYTES = 64 << 20; //how big the journal can get before it's worth compacting
+    static const size_t FLUSH_BYTES = 1 << 20; //how many bytes of records can wait in memory before they get written no matter the policy
+
+    //journals into the file at the given path (and path.snap for the snapshot, path.old for the journal being compacted away).
+    //groupMillis is how long the GROUP policy waits between fsyncs
+    Journal(const std::string& path, SyncPolicy policy, unsigned groupMillis = 100);
+    ~Journal(); //writes and fsyncs everything still waiting and waits for any compaction to finish
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    //loads the snapshot and replays the journals into the (empty) table, moving nextID past every ID found, and then opens the journal for
+    //appending. If a compaction got cut off by a crash, everything gets compacted again right away so no leftovers stay around. Returns false
+    //with the reason in error if the journal can't be written to
+    template <class Table>
+    bool recover(Table& table, int& nextID, size_t& replayed, std::string& error) {
+        replayed = 0;
+        uint32_t base = 0; //the snapshot's generation, no snapshot just means we haven't compacted yet
+        if (exists(snapshotPath()) && !Snapshot::Load(table, snapshotPath(), nextID, error, &base)) {
+            error = "the snapshot " + snapshotPath() + " is unreadable, " + error;
+            return false;
+        }
+        std::vector<Change> oldChanges;
+        std::vector<Change> changes;
+        uint32_t oldGeneration = 0;
+        uint32_t journalGeneration = 0;
+        bool hasOld = readChanges(oldPath(), oldChanges, oldGeneration); //only there if we crashed while compacting
+        bool hasJournal = readChanges(path, changes, journalGeneration);
+        //.old only counts if its compaction didn't get as far as writing the snapshot, and the journal only if it came right after the snapshot
+        //or after that .old. Anything else was written before a newer snapshot that already has (or on purpose doesn't have) its changes
+        bool oldApplies = hasOld && oldGeneration == base;
+        bool journalApplies = hasJournal && (journalGeneration == base || (oldApplies && journalGeneration == base + 1));
+        generation = journalApplies ? journalGeneration : base;
+        if (exists(path) && !hasJournal && !open(error)) { //something that isn't one of our journals, open says what's wrong with it
+            return false;
+        }
+        if (oldApplies) {
+            replayed += replay(table, oldChanges, nextID);
+        }
+        if (journalApplies) {
+            replayed += replay(table, changes, nextID);
+        }
+        if (hasOld || (hasJournal && !journalApplies)) {
+            Snapshot::Columns* columns = new Snapshot::Columns();
+            Snapshot::Collect(table, nextID, *columns);
+            return restartNow(columns, error);
+        }
+        return fd >= 0 || open(error);
+    }
+
+    void add(Student& student); //journals a new student
+    void remove(int id); //journals a deleted student
+    void sync(); //writes and fsyncs everything journaled so far, whatever the policy
+
+    bool wantsCompaction() const { //whether the journal got big enough that it should be compacted (and isn't being compacted already)
+        return size > COMPACT_BYTES && !compacting && !failed;
+    }
+    //compacts the journal: the table gets copied here, then the journal starts over and the copy gets written as the snapshot in the background
+    template <class Table>
+    void compact(Table& table, int nextID) {
+        Snapshot::Columns* columns = new Snapshot::Columns();
+        Snapshot::Collect(table, nextID, *columns);
+        restart(columns);
+    }
+    //compacts the journal without the background thread: the snapshot is on disk before the journal starts over. For after LOAD, whose
+    //students aren't in the journal, so the journal from before it must never get replayed on top of the new snapshot
+    template <class Table>
+    void compactNow(Table& table, int nextID) {
+        if (fd < 0 || failed) {
+            return;
+        }
+        Snapshot::Columns* columns = new Snapshot::Columns();
+        Snapshot::Collect(table, nextID, *columns);
+        std::string error;
+        restartNow(columns, error);
+    }
+    bool hasFailed() const { //whether writing to the journal ever failed, in which case changes aren't safe anymore
+        return failed;
+    }
+private:
+    //record types, every record is a 4-byte checksum of the rest of the record, then the type, then the data
+    static const uint8_t RECORD_ADD = 1; //then the id, gpa, first and last name lengths (4 bytes each), and the names
+    static const uint8_t RECORD_DELETE = 2; //then the id
+
+    std::string snapshotPath() const {
+        return path + ".snap";
+    }
+    std::string oldPath() const {
+        return path + ".old";
+    }
+    static bool exists(const std::string& file);
+
+    //reads the records of the journal at the given path into a list of students to add and IDs to delete, in order. Cuts off a torn
+    //record at the end (from crashing in the middle of a write) so new records don't end up after garbage
+    struct Change {
+        bool add; //whether it's an add or a delete
+        int id;
+        float gpa;
+        std::string firstname;
+        std::string lastname;
+    };
+    //Returns false if there's no journal there, otherwise generation gets the journal's
+    static bool readChanges(const std::string& path, std::vector<Change>& changes, uint32_t& generation);
+    //applies the changes to the table, returns how many there were
+    template <class Table>
+    static size_t replay(Table& table, std::vector<Change>& changes, int& nextID) {
+        for (Change& change : changes) {
+            if (change.add) {
+                table.insert(change.id, Student(change.firstname, change.lastname, change.id, change.gpa));
+                if (change.id >= nextID) {
+                    nextID = change.id + 1;
+                }
+            } else {
+                table.erase(change.id);
+            }
+        }
+        return changes.size();
+    }
+
+    bool open(std::string& error); //opens the journal for appending, writing the file header if it's new
+    void append(const char* record, size_t size); //journals a record according to the policy
+    void writeOut(bool sync); //writes everything waiting in the buffer, needs fileLock
+    void restart(Snapshot::Columns* columns); //the part of compact that doesn't depend on the table
+    bool restartNow(Snapshot::Columns* columns, std::string& error); //the same for compactNow, returns false with the reason in error if it failed
+    void flushLoop(); //the GROUP policy's background thread
+
+    std::string path;
+    SyncPolicy policy;
+    unsigned groupMillis;
+    int fd; //the journal file, -1 if it isn't open
+    std::atomic<size_t> size; //how big the journal file is
+    uint32_t generation; //the journal's generation, which is also the one of the snapshot being written by the compactor (if there is one)
+    std::atomic<bool> failed; //atomic since the background threads can fail too
+    std::atomic<bool> compacting; //whether the compactor is still writing the snapshot
+
+    std::mutex bufferLock; //guards buffer, so adding to it never waits on a write or fsync
+    std::vector<char> buffer; //records that haven't been written yet
+    std::mutex fileLock; //guards fd and size, held while writing and fsyncing
+    std::condition_variable wake; //wakes the flusher up early, when stopping or when the buffer gets big
+    bool stopping;
+    std::thread flusher;
+    std::thread compactor; //writes the snapshot during a compaction
+};
+#endif
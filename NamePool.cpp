@@ -0,0 +1,88 @@
+//implementation file for the name pool
+
+#include "NamePool.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+using namespace std;
+
+namespace {
+    const size_t ARENA_BLOCK = 1 << 16; //the letters go in blocks of 64 KB, a name that doesn't fit in one gets a block of its own
+    const size_t CHUNK = 1 << 16; //the IDs' texts go in chunks of this many, so the chunks never have to move when there's more names
+    const size_t MAX_CHUNKS = 1 << 16; //which is 2^32 names, one per ID
+
+    mutex poolLock; //taken by anything that adds names, Get doesn't need it
+    vector<char*> blocks; //every arena block
+    size_t blockUsed = ARENA_BLOCK; //how much of the last block is used, full to begin with so the first name makes a block
+    string_view* chunks[MAX_CHUNKS]; //the text of every ID, chunks[id / CHUNK][id % CHUNK]
+    size_t count = 0;
+    unordered_map<string_view, uint32_t> ids; //the views point into the arena, so they stay valid as long as the pool does
+    size_t arenaBytes = 0;
+
+    //copies the name into the arena, the lock has to be held
+    string_view store(string_view name) {
+        if (name.size() > ARENA_BLOCK - blockUsed) {
+            size_t size = name.size() > ARENA_BLOCK ? name.size() : ARENA_BLOCK;
+            blocks.push_back((char*)malloc(size));
+            arenaBytes += size;
+            blockUsed = 0;
+        }
+        char* text = blocks.back() + blockUsed;
+        memcpy(text, name.data(), name.size());
+        blockUsed += name.size();
+        return string_view(text, name.size());
+    }
+}
+
+uint32_t NamePool::Intern(string_view name) {
+    lock_guard<mutex> guard(poolLock);
+    unordered_map<string_view, uint32_t>::iterator it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    uint32_t id = count;
+    if (id % CHUNK == 0) {
+        chunks[id / CHUNK] = new string_view[CHUNK];
+    }
+    string_view text = store(name);
+    chunks[id / CHUNK][id % CHUNK] = text; //written before anyone gets the ID, so Get never sees it empty
+    ids.emplace(text, id);
+    count++;
+    return id;
+}
+
+vector<uint32_t> NamePool::InternAll(const vector<string>& names) {
+    vector<uint32_t> result;
+    result.reserve(names.size());
+    for (const string& name : names) {
+        result.push_back(Intern(name));
+    }
+    return result;
+}
+
+bool NamePool::Find(string_view name, uint32_t& id) {
+    lock_guard<mutex> guard(poolLock);
+    unordered_map<string_view, uint32_t>::iterator it = ids.find(name);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+string_view NamePool::Get(uint32_t id) {
+    return chunks[id / CHUNK][id % CHUNK];
+}
+
+size_t NamePool::Count() {
+    lock_guard<mutex> guard(poolLock);
+    return count;
+}
+
+size_t NamePool::Bytes() {
+    lock_guard<mutex> guard(poolLock);
+    size_t chunkBytes = (count + CHUNK - 1) / CHUNK * CHUNK * sizeof(string_view);
+    size_t mapBytes = ids.bucket_count() * sizeof(void*) + ids.size() * (sizeof(pair<string_view, uint32_t>) + 2 * sizeof(void*));
+    return arenaBytes + chunkBytes + mapBytes;
+}
@@ -0,0 +1,30 @@
+//header file for the name pool, where every distinct name is stored exactly once and students only keep a 32-bit ID for each of their
+//names. Generated students all get their names from the same two short lists, so instead of every student carrying two strings of their own
+//(32 bytes each, and a heap allocation for anything longer than 15 letters) they now just carry 8 bytes of IDs. The letters live in big arena
+//blocks that are never freed or moved, so the text of an ID stays valid forever: reloading the name files or deleting every student with a
+//name doesn't touch the names anyone already has, and Student doesn't need a destructor at all, so deleting every student is just freeing
+//the table's memory
+
+#ifndef NAME_POOL
+#define NAME_POOL
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NamePool {
+    //the ID of the name, adding it to the pool if it isn't there yet. Safe to call from several threads at once
+    uint32_t Intern(std::string_view name);
+    //interns every name in the list, for when the same names get used over and over (like the name files while generating)
+    std::vector<uint32_t> InternAll(const std::vector<std::string>& names);
+    //finds the ID of the name without adding it, returns false if nobody ever had the name
+    bool Find(std::string_view name, uint32_t& id);
+    //the text of the name with the given ID. Doesn't lock anything, since the text of an ID never changes once it's handed out
+    std::string_view Get(uint32_t id);
+
+    size_t Count(); //how many distinct names there are
+    size_t Bytes(); //how much memory the pool takes up, the arena, the ID lookup, and the map for finding names
+}
+#endif
@@ -1,25 +1,35 @@
-//header file for nodes
-
-#ifndef NODE
-#define NODE
-
-#include <string>
-
-class Student; //forward declare student class so we can use it here without #including Student.h
-
-class Node {
-public:
-    Node(Student* _student, const std::string& _hash); //constructor, requires student to point to and a hash, and sets nextNode to NULL to start
-    ~Node(); //destructor which also deletes the student
-    
-    void setNext(Node* next); //sets the node which goes after this node and is gotten from getNext
-    
-    Student* getStudent(); //get the student associated with this node
-    Node* getNext(); //get the node that goes after this one
-    const std::string& getHash(); //get the hash associated with this node
-private:
-    Node* nextNode; //the next node that goes after this one in the linked list, defaults to NULL in constructor
-    Student* student; //the student pointed to by this node
-    std::string hash; //the hash for the hash table, stored so we can get the new index when rehashing without having to generate the hashes all over again
-};
-#endif
\ No newline at end of file
+//header file for nodes, which are templated so the hash table can hold any type of key and value (no .cpp because templates have to be in headers)
+
+#ifndef NODE
+#define NODE
+
+#include <cstdint>
+
+template <class K, class V>
+class Node {
+public:
+    Node(const K& _key, const V& _value, uint64_t _hash) : nextNode(NULL), key(_key), value(_value), hash(_hash) {} //constructor, requires the key, the value it maps to, and the key's hash, and sets nextNode to NULL to start
+
+    void setNext(Node* next) { //sets the node which goes after this node and is gotten from getNext
+        nextNode = next;
+    }
+
+    K& getKey() { //get the key associated with this node (the student's ID in the database)
+        return key;
+    }
+    V& getValue() { //get the value associated with this node (the student in the database)
+        return value;
+    }
+    Node* getNext() { //get the node that goes after this one
+        return nextNode;
+    }
+    uint64_t getHash() { //get the hash associated with this node
+        return hash;
+    }
+private:
+    Node* nextNode; //the next node that goes after this one in the linked list, defaults to NULL in constructor
+    K key; //the key that was hashed
+    V value; //the value stored in this node, stored right in the node so it gets deleted along with it
+    uint64_t hash; //the folded hash for the hash table, stored inline so when rehashing we get the new index with just a mask instead of generating the hashes all over again
+};
+#endif
@@ -0,0 +1,123 @@
+//header file for the node pool, a slab allocator that hands out objects from big contiguous slabs instead of asking new for every single one.
+//Deleted objects go on a free list and get reused by the next allocation, and all the slabs can be released at once without visiting each
+//object (no .cpp because templates have to be in headers)
+
+#ifndef NODE_POOL
+#define NODE_POOL
+
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <class T>
+class NodePool {
+public:
+    static const size_t SLAB_SIZE = 4096; //how many objects fit in one slab
+
+    NodePool() : freeList(NULL), next(0), live(0) {}
+    ~NodePool() {
+        releaseAll();
+    }
+    NodePool(const NodePool&) = delete; //the pool owns its slabs
+    NodePool& operator=(const NodePool&) = delete;
+
+    //constructs a new object with the given constructor arguments in a free spot, reusing a deleted object's spot if there is one
+    template <class... Args>
+    T* create(Args&&... args) {
+        return new (allocate()) T(std::forward<Args>(args)...);
+    }
+
+    //hands out a free spot without constructing anything in it, for when the objects get constructed later (on other threads, even).
+    //The spot counts as alive, so it has to either get an object constructed in it or be given back with deallocate
+    T* allocate() {
+        void* spot;
+        if (freeList != NULL) { //reuse the most recently deleted spot first, it's the most likely to still be in the cache
+            spot = freeList;
+            freeList = freeList->next;
+        } else {
+            if (slabs.empty() || next == SLAB_SIZE) { //the current slab is full, so get a new one
+                Slot* slab = static_cast<Slot*>(malloc(sizeof(Slot) * SLAB_SIZE));
+                if (slab == NULL) {
+                    throw std::bad_alloc();
+                }
+                slabs.push_back(slab);
+                next = 0;
+            }
+            spot = &slabs.back()[next++];
+        }
+        live++;
+        return static_cast<T*>(spot);
+    }
+
+    //gives back a spot from allocate that never got an object constructed in it
+    void deallocate(T* object) {
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        live--;
+    }
+
+    //destroys the object and puts its spot on the free list
+    void destroy(T* object) {
+        object->~T();
+        deallocate(object);
+    }
+
+    //destroys every live object and frees every slab. Instead of following whatever structure points at the objects, this goes straight
+    //through the slabs in memory order, skipping the spots on the free list, and if the objects don't need destructors it skips straight to freeing
+    void destroyAll() {
+        if (!std::is_trivially_destructible<T>::value) {
+            std::vector<Slot*> freed; //the free spots, sorted so we can quickly check if a spot is one of them
+            for (Slot* slot = freeList; slot != NULL; slot = slot->next) {
+                freed.push_back(slot);
+            }
+            std::sort(freed.begin(), freed.end());
+            for (size_t i = 0; i < slabs.size(); i++) {
+                size_t used = i + 1 == slabs.size() ? next : SLAB_SIZE; //only the last slab can be partly unused
+                for (size_t j = 0; j < used; j++) {
+                    Slot* slot = &slabs[i][j];
+                    if (!std::binary_search(freed.begin(), freed.end(), slot)) {
+                        reinterpret_cast<T*>(slot)->~T();
+                    }
+                }
+            }
+        }
+        releaseAll();
+    }
+
+    //frees every slab at once without running any destructors, so either the objects don't need them or they were already destroyed
+    void releaseAll() {
+        for (Slot* slab : slabs) {
+            free(slab);
+        }
+        slabs.clear();
+        freeList = NULL;
+        next = 0;
+        live = 0;
+    }
+
+    size_t size() const { //how many objects are alive
+        return live;
+    }
+    size_t slabCount() const { //how many slabs have been allocated, which is how many times we actually asked for memory
+        return slabs.size();
+    }
+    size_t bytes() const { //how much memory the slabs take up
+        return slabs.size() * SLAB_SIZE * sizeof(Slot);
+    }
+private:
+    union Slot { //each spot in a slab is either an object or, if it's free, a link to the next free spot
+        Slot* next;
+        alignas(T) unsigned char object[sizeof(T)];
+    };
+
+    std::vector<Slot*> slabs; //every slab we've allocated
+    Slot* freeList; //the most recently freed spot, which links to the one freed before it and so on
+    size_t next; //the next never-used spot in the last slab
+    size_t live; //how many objects are alive
+};
+#endif
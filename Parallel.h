@@ -0,0 +1,35 @@
+//header file for the little bit of threading the tables need for bulk loads: splitting a range of work evenly over some threads
+//(no .cpp because templates have to be in headers)
+
+#ifndef PARALLEL
+#define PARALLEL
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//the amount of threads to use when the caller doesn't care, which is one per core (hardware_concurrency can say 0 if it doesn't know)
+inline unsigned defaultThreads() {
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+}
+
+//splits [0, n) into the given amount of equal chunks and calls work(begin, end, chunk) on each, each chunk on its own thread. The calling
+//thread does the last chunk itself instead of just waiting around. The chunks only depend on n and threads, so calling this twice with the
+//same numbers gives every thread the same chunk both times
+template <class Work>
+void parallelFor(size_t n, unsigned threads, Work work) {
+    if (threads <= 1) { //no point starting a thread just to wait for it
+        work((size_t)0, n, 0u);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t + 1 < threads; t++) {
+        workers.emplace_back(work, n * t / threads, n * (t + 1) / threads, t);
+    }
+    work(n * (threads - 1) / threads, n, threads - 1);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+#endif
@@ -0,0 +1,22 @@
+//implementation file for read views
+
+#include "ReadView.h"
+using namespace std;
+
+const uint32_t ReadView::NOT_COPIED;
+
+ReadView::ReadView(size_t _students) : students(_students), read(0), inTable(true), at(0), nextCopy(0), changed(16) {}
+
+void ReadView::added(int id) {
+    changed.insert(id, NOT_COPIED); //does nothing if it's already there
+}
+
+void ReadView::erasing(int id, const Student& student) {
+    if (changed.insert(id, copied.size())) { //if it was already there, the view either has a copy already or never had the student
+        copied.push_back(student);
+    }
+}
+
+size_t ReadView::bytes() const {
+    return copied.capacity() * sizeof(Student) + changed.bytes();
+}
@@ -0,0 +1,71 @@
+//header file for read views, the point-in-time views of every student that VIEW opens, so a client paging through the students over many
+//READs sees exactly the students there were when it opened the view, no matter what other clients ADD, DELETE, GENERATE or LOAD in between
+//(SCAN only promises that the students who were there the whole time show up, and PRINT only sees one moment because it's one command).
+//Opening a view copies nothing. It's copy on write, but only for the part of the table the view's scan hasn't gotten to yet: the view scans
+//the live table in the engine's cursor order (see Cursor.h), so the StudentTable can tell from a student's hash whether the scan already went
+//past them. A student who gets erased before the scan gets to them is copied into the view first, and an ID that gets added where the scan
+//is still going is written down so the scan skips it. Changes behind the scan cost nothing, so a view gets cheaper to keep open the further
+//it's read, and once the scan is through the live table nothing gets written down at all. Views are shared_ptrs, the StudentTable keeps one
+//for every open view to tell them about changes, and drops it once nobody else has one (or the view has been read to the end), which is
+//when the copies get freed. While any view is open the table doesn't shrink, since shrinking makes a scan go over some buckets twice
+
+#ifndef READ_VIEW
+#define READ_VIEW
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Student.h"
+#include "Hashers.h"
+#include "FlatTable.h"
+
+template <class Table> class StudentTable;
+
+class ReadView {
+public:
+    ReadView(size_t students); //a view of the given amount of students, however many the table had when it was opened
+
+    //an ID was added somewhere the scan still has to go, so the scan has to skip it. Nothing happens if the ID was already written down, like
+    //a student that got erased and then added again (the view still has the copy from before)
+    void added(int id);
+    //a student the scan still has to get to is about to be erased, so the view keeps a copy, unless the ID is one the view doesn't have
+    void erasing(int id, const Student& student);
+
+    //whether the live student with this ID isn't one the view has, because they were added after it was opened (or erased and added again)
+    bool hides(int id) {
+        return !changed.empty() && changed.find(id) != NULL;
+    }
+    bool reading() const { //whether the scan is still going through the live table, only then do changes have to be written down
+        return inTable;
+    }
+    size_t cursor() const { //where the scan is in the live table
+        return at;
+    }
+
+    size_t size() const { //how many students the view has
+        return students;
+    }
+    size_t left() const { //how many of them haven't been read yet
+        return students - read;
+    }
+    bool done() const {
+        return read == students;
+    }
+    size_t copies() const { //how many students had to be copied because they were erased before the scan got to them
+        return copied.size();
+    }
+    size_t bytes() const; //the copies and the IDs written down
+private:
+    template <class Table> friend class StudentTable; //reads the view, moving the cursor along
+
+    static const uint32_t NOT_COPIED = UINT32_MAX; //what changed has for IDs that were added, instead of where their copy is
+
+    size_t students;
+    size_t read; //how many students have been read so far
+    bool inTable; //whether the scan is still going through the live table, after that it's the copies
+    size_t at; //the live table's scan cursor
+    size_t nextCopy; //the next copy to read, once the scan is through the live table
+    FlatTable<int, uint32_t, MixHasher> changed; //every ID that was written down, with where its copy is in copied (or NOT_COPIED)
+    std::vector<Student> copied;
+};
+#endif
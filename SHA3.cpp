@@ -1,135 +1,387 @@
-//implementation file for the SHA-3 hash algorithm, featuring Keccak-f[1600]
-
-#include <cstdint> //this is a very low-level hash algorithm for efficiency, which is why we use special variable types (these include those types)
-#include <cstddef>
-#include <cstring>
-#include <string>
-using namespace std;
-
-namespace SHA3 {
-    //bitwise rotation left by "shift" spaces for the given 64-bit integer
-    uint64_t rotl64(uint64_t bits, int shift) {
-        if (!shift) { //if there's 0 shift we just return the bits unchanged, we have to specifically check for this because uint64_t >> 64 is apparently undefined behavior
-            return bits;
-        }//moves all the bits to the left by amount "shift". This discards the leftmost bits, so we also move the bits 64-shift to the right, therefore discarding everything but the leftmost ones which are now pushed all the way to the right
-        //after ORing the two, they're effectively combined since there's no overlap
-        return (bits << shift) | (bits >> (64-shift));
-    }
-    //used during the rho step to get the amount to rotl each column by. The numbers were chosen by the makers of SHA-3 to ensure maximum scrambled-ness
-    static const int rhotations[25] = {
-        0,  1,  62, 28, 27,
-        36, 44, 6,  55, 20,
-        3,  10, 43, 25, 39,
-        41, 45, 15, 21, 8,
-        18, 2,  61, 56, 14
-    };
-    //used during the pi step to more efficiently compute r +(2*c+3*r)%5*5, which is the position that the current item in state gets moved to. This formula was chosen similarly to and alongside the above rhotations to ensure maximum scrambled-ness
-    static const int piShuffle[25] = {
-        0,  10, 20, 5,  15,
-        16, 1,  11, 21, 6,
-        7,  17, 2,  12, 22,
-        23, 8,  18, 3,  13,
-        14, 24, 9,  19, 4
-    };
-    //used during the iota step, each keccak round uses a different one, which is xor'd into the first item in state. The constants were generated to look random and they're standardized so they're what every SHA-3 uses 
-    static const uint64_t iotaConstants[24] = {
-        0x0000000000000001ULL, 0x0000000000008082ULL, //ULL means Unsigned Long Long
-        0x800000000000808AULL, 0x8000000080008000ULL,
-        0x000000000000808BULL, 0x0000000080000001ULL,
-        0x8000000080008081ULL, 0x8000000000008009ULL,
-        0x000000000000008AULL, 0x0000000000000088ULL,
-        0x0000000080008009ULL, 0x000000008000000AULL,
-        0x000000008000808BULL, 0x800000000000008BULL,
-        0x8000000000008089ULL, 0x8000000000008003ULL,
-        0x8000000000008002ULL, 0x8000000000000080ULL,
-        0x000000000000800AULL, 0x800000008000000AULL,
-        0x8000000080008081ULL, 0x8000000000008080ULL,
-        0x0000000080000001ULL, 0x8000000080008008ULL
-    };
-    //the rate used by SHA-3 256 is standardized as 136. If I ever wanted to change SHA-3s I need to change the rate here
-    static constexpr size_t RATE = 136;
-    //keccak the given state array (pronounced ketch-ak), done in 5 greek letter steps: THETA, RHO, PI, CHI, and IOTA, and we do that 24 times
-    void KeccakIt(uint64_t state[25]) {
-        for (int round = 0; round < 24; round++) {
-            //THETA STEP, diffuse each column with its adjacent columns
-            uint64_t ColCol[5]; //stands for Collapsed Column
-            for (int c = 0; c < 5; c++) { //collapse each column into one 64-bit int by xoring all the rows
-                ColCol[c] = state[c]^state[c+5]^state[c+10]^state[c+15]^state[c+20];
-            }
-            //diffuse each column with its neighbors by xoring it with the left ColCol xor'd with (the right ColCol rotled by 1)
-            for (int c = 0; c < 5; c++) { //for each column, figure out the mixture (described above) of the adjacent columns (looping around the edges)
-                //we have to +4 instead of -1 because C++ modulo can't handle negatives
-                uint64_t lr = ColCol[(c+4)%5] ^ rotl64(ColCol[(c+1)%5], 1);
-                for (int r = 0; r < 5; r++) { //for each row in the column, xor it with the neighbors
-                    state[c + 5*r] ^= lr;
-                }
-            }
-            //RHO STEP, rotl each column according to the hardcoded rhotations
-            uint64_t copy[25];
-            for (int i = 0; i < 25; i++) {
-                copy[i] = rotl64(state[i], rhotations[i]);
-            }
-            //PI STEP, shuffle all the 64-bit ints according to the hardcoded piShuffles, which is based on r +(2*c+3*r)%5*5
-            for (int i = 0; i < 25; i++) {
-                state[piShuffle[i]] = copy[i];
-            }
-            //CHI STEP, xors each item with its ((inverted following neighbor) anded with the following following neighbor), in order to make it unpredictable with linear algebra
-            memcpy(copy, state, sizeof(copy)); //copies the state as of the pi step so we can use that while still modifying state
-            for (int c = 0; c < 5; c++) {
-                for (int r = 0; r < 5; r++) {
-                    state[c+5*r] ^= (~copy[(c+1)%5+5*r] & copy[(c+2)%5+5*r]);
-                }
-            }
-            //IOTA STEP, just xor the current round's iotaConstant into the first item in state. This is done to prevent edge cases where the result of the above four steps was just the original (for example, an input of all 0s)
-            state[0] ^= iotaConstants[round];
-        }
-    }
-    //absorbs the input into state in RATE-sized blocks and runs each block through Keccak
-    void Absorb(uint64_t state[25], const uint8_t* input, size_t inputSize) {
-        //reinterpret state as a bytes object so we can modify the bits of state
-        uint8_t* stateBytes = reinterpret_cast<uint8_t*>(state);
-        //while the input is able to be divided into RATE-sized blocks without padding
-        while (inputSize >= RATE) { //technically this program just skips this loop since I just input 4-byte ints but I included this check in case I ever wanted to use it for something else
-            for (size_t i = 0; i < RATE; i++) { //xor the next RATE bytes of input into state
-                stateBytes[i] ^= input[i];
-            } //do the whole Keccak process with the newly updated state
-            KeccakIt(state);
-            input += RATE; //moves the pointer forward because we don't need to read the data again
-            inputSize -= RATE; //removes RATE amount from the input size so at the end we know how much input is left to process
-        } //the last block of data left to process, we put it into a RATE-sized block of 0s
-        uint8_t end[RATE] = {0};
-        memcpy(end, input, inputSize); //put the remaining input into the end block
-        //standardized padding; 6 after the remaining input and 128 at the end
-        end[inputSize] = 6;
-        end[RATE-1] |= 128; //we or it into end to account for the edge case where inputSize == RATE - 1, so the 128 doesn't just overwrite the 6
-        for (size_t i = 0; i < RATE; i++) { //xor the last block into state
-            stateBytes[i] ^= end[i];
-        } //normally there would be a final KeccakIt(state) here but I moved it to Squeeze
-    }
-    //squeezes the output from state
-    void Squeeze(uint64_t state[25], uint8_t* output, size_t outputSize) {
-        //reinterpret state as a bytes object so we can deal with the specific bits rather than pesky 64-bit 8-byte integers
-        uint8_t* stateBytes = reinterpret_cast<uint8_t*>(state);
-
-        //while we still need to write more output
-        while (outputSize > 0) {
-            KeccakIt(state); //Keccak the last block from Absorb on the first go, or to extract different bytes from the sponge on the subsequent goes
-            //if we don't have at least RATE bytes left to output, we only check the remaining outputSize bytes. Otherwise, we keep adding to the output in RATE-sized blocks
-            size_t blockSize = (outputSize < RATE) ? outputSize : RATE;
-            //copy the next blockSize bytes into the output from state
-            memcpy(output, stateBytes, blockSize);
-            outputSize -= blockSize; //subtract from outputSize so we know how many bytes we still need to output
-            output += blockSize; //moves the output pointer forward so we keep writing output in the next loop where we left off in this loop
-        }
-    }
-    //creates a 256-bit 32-byte hash stored as a string using the inputted integer
-    string Hash(const int input) {
-        uint64_t state[25] = {0}; //creates the state array which will be used to process the input
-        //absorb the state into the "sponge", using the data from the input which is byte-ified
-        Absorb(state, reinterpret_cast<const uint8_t*>(&input), sizeof(input));
-        string hash(32, '\0'); //creates the container for the hash bytes, SHA-3 256 creates a 32-byte hash so we make sure the string is that length
-        //extract the hash from the sponge into the hash string (which is byte-ified to allow for the modification of the individual bits)
-        Squeeze(state, reinterpret_cast<uint8_t*>(&hash[0]), hash.size());
-        return hash; //return the generated hash! lets goooooooooooooooooooooooooooooo
-    }
+//implementation file for the SHA-3 hash algorithm, featuring Keccak-f[1600]
+
+#include <cstdint> //this is a very low-level hash algorithm for efficiency, which is why we use special variable types (these include those types)
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include "SHA3.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> //for the AVX2 and AVX-512 batch hashing, which only gets used if the cpu supports it
+#endif
+using namespace std;
+
+namespace SHA3 {
+    //bitwise rotation left by "shift" spaces for the given 64-bit integer
+    uint64_t rotl64(uint64_t bits, int shift) {
+        if (!shift) { //if there's 0 shift we just return the bits unchanged, we have to specifically check for this because uint64_t >> 64 is apparently undefined behavior
+            return bits;
+        }//moves all the bits to the left by amount "shift". This discards the leftmost bits, so we also move the bits 64-shift to the right, therefore discarding everything but the leftmost ones which are now pushed all the way to the right
+        //after ORing the two, they're effectively combined since there's no overlap
+        return (bits << shift) | (bits >> (64-shift));
+    }
+    //used during the rho step to get the amount to rotl each column by. The numbers were chosen by the makers of SHA-3 to ensure maximum scrambled-ness
+    static const int rhotations[25] = {
+        0,  1,  62, 28, 27,
+        36, 44, 6,  55, 20,
+        3,  10, 43, 25, 39,
+        41, 45, 15, 21, 8,
+        18, 2,  61, 56, 14
+    };
+    //used during the pi step to more efficiently compute r +(2*c+3*r)%5*5, which is the position that the current item in state gets moved to. This formula was chosen similarly to and alongside the above rhotations to ensure maximum scrambled-ness
+    static const int piShuffle[25] = {
+        0,  10, 20, 5,  15,
+        16, 1,  11, 21, 6,
+        7,  17, 2,  12, 22,
+        23, 8,  18, 3,  13,
+        14, 24, 9,  19, 4
+    };
+    //used during the iota step, each keccak round uses a different one, which is xor'd into the first item in state. The constants were generated to look random and they're standardized so they're what every SHA-3 uses 
+    static const uint64_t iotaConstants[24] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, //ULL means Unsigned Long Long
+        0x800000000000808AULL, 0x8000000080008000ULL,
+        0x000000000000808BULL, 0x0000000080000001ULL,
+        0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008AULL, 0x0000000000000088ULL,
+        0x0000000080008009ULL, 0x000000008000000AULL,
+        0x000000008000808BULL, 0x800000000000008BULL,
+        0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL,
+        0x000000000000800AULL, 0x800000008000000AULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL,
+        0x0000000080000001ULL, 0x8000000080008008ULL
+    };
+    //keccak the given state array (pronounced ketch-ak), done in 5 greek letter steps: THETA, RHO, PI, CHI, and IOTA, and we do that 24 times
+    void KeccakIt(uint64_t state[25]) {
+        for (int round = 0; round < 24; round++) {
+            //THETA STEP, diffuse each column with its adjacent columns
+            uint64_t ColCol[5]; //stands for Collapsed Column
+            for (int c = 0; c < 5; c++) { //collapse each column into one 64-bit int by xoring all the rows
+                ColCol[c] = state[c]^state[c+5]^state[c+10]^state[c+15]^state[c+20];
+            }
+            //diffuse each column with its neighbors by xoring it with the left ColCol xor'd with (the right ColCol rotled by 1)
+            for (int c = 0; c < 5; c++) { //for each column, figure out the mixture (described above) of the adjacent columns (looping around the edges)
+                //we have to +4 instead of -1 because C++ modulo can't handle negatives
+                uint64_t lr = ColCol[(c+4)%5] ^ rotl64(ColCol[(c+1)%5], 1);
+                for (int r = 0; r < 5; r++) { //for each row in the column, xor it with the neighbors
+                    state[c + 5*r] ^= lr;
+                }
+            }
+            //RHO STEP, rotl each column according to the hardcoded rhotations
+            uint64_t copy[25];
+            for (int i = 0; i < 25; i++) {
+                copy[i] = rotl64(state[i], rhotations[i]);
+            }
+            //PI STEP, shuffle all the 64-bit ints according to the hardcoded piShuffles, which is based on r +(2*c+3*r)%5*5
+            for (int i = 0; i < 25; i++) {
+                state[piShuffle[i]] = copy[i];
+            }
+            //CHI STEP, xors each item with its ((inverted following neighbor) anded with the following following neighbor), in order to make it unpredictable with linear algebra
+            memcpy(copy, state, sizeof(copy)); //copies the state as of the pi step so we can use that while still modifying state
+            for (int c = 0; c < 5; c++) {
+                for (int r = 0; r < 5; r++) {
+                    state[c+5*r] ^= (~copy[(c+1)%5+5*r] & copy[(c+2)%5+5*r]);
+                }
+            }
+            //IOTA STEP, just xor the current round's iotaConstant into the first item in state. This is done to prevent edge cases where the result of the above four steps was just the original (for example, an input of all 0s)
+            state[0] ^= iotaConstants[round];
+        }
+    }
+    //rotl64 for a shift known at compile time, so it becomes a single rotate instruction
+    template <int shift>
+    static inline uint64_t rotlConst(uint64_t bits) {
+        return shift ? (bits << shift) | (bits >> ((64 - shift) & 63)) : bits; //the &63 keeps the shift in range even for the shift == 0 branch that never runs
+    }
+    //KeccakIt with every step of a round written out, so all the indices and rotation amounts are constants the compiler can bake in instead of
+    //doing %5 math and looking them up in rhotations and piShuffle. The state gets loaded into 25 local variables so it can live in registers
+    void KeccakUnrolled(uint64_t state[25]) {
+        uint64_t s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3], s4 = state[4], s5 = state[5], s6 = state[6], s7 = state[7], s8 = state[8], s9 = state[9], s10 = state[10], s11 = state[11], s12 = state[12];
+        uint64_t s13 = state[13], s14 = state[14], s15 = state[15], s16 = state[16], s17 = state[17], s18 = state[18], s19 = state[19], s20 = state[20], s21 = state[21], s22 = state[22], s23 = state[23], s24 = state[24];
+        for (int round = 0; round < 24; round++) {
+            //THETA STEP, collapse the columns and diffuse them with their neighbors
+            uint64_t C0 = s0^s5^s10^s15^s20;
+            uint64_t C1 = s1^s6^s11^s16^s21;
+            uint64_t C2 = s2^s7^s12^s17^s22;
+            uint64_t C3 = s3^s8^s13^s18^s23;
+            uint64_t C4 = s4^s9^s14^s19^s24;
+            uint64_t D0 = C4 ^ rotlConst<1>(C1);
+            uint64_t D1 = C0 ^ rotlConst<1>(C2);
+            uint64_t D2 = C1 ^ rotlConst<1>(C3);
+            uint64_t D3 = C2 ^ rotlConst<1>(C4);
+            uint64_t D4 = C3 ^ rotlConst<1>(C0);
+            //RHO and PI STEPS, each lane gets its D xored in, rotated by its constant rhotation, and moved to its piShuffle position
+            uint64_t B0 = rotlConst<0>(s0 ^ D0);
+            uint64_t B1 = rotlConst<44>(s6 ^ D1);
+            uint64_t B2 = rotlConst<43>(s12 ^ D2);
+            uint64_t B3 = rotlConst<21>(s18 ^ D3);
+            uint64_t B4 = rotlConst<14>(s24 ^ D4);
+            uint64_t B5 = rotlConst<28>(s3 ^ D3);
+            uint64_t B6 = rotlConst<20>(s9 ^ D4);
+            uint64_t B7 = rotlConst<3>(s10 ^ D0);
+            uint64_t B8 = rotlConst<45>(s16 ^ D1);
+            uint64_t B9 = rotlConst<61>(s22 ^ D2);
+            uint64_t B10 = rotlConst<1>(s1 ^ D1);
+            uint64_t B11 = rotlConst<6>(s7 ^ D2);
+            uint64_t B12 = rotlConst<25>(s13 ^ D3);
+            uint64_t B13 = rotlConst<8>(s19 ^ D4);
+            uint64_t B14 = rotlConst<18>(s20 ^ D0);
+            uint64_t B15 = rotlConst<27>(s4 ^ D4);
+            uint64_t B16 = rotlConst<36>(s5 ^ D0);
+            uint64_t B17 = rotlConst<10>(s11 ^ D1);
+            uint64_t B18 = rotlConst<15>(s17 ^ D2);
+            uint64_t B19 = rotlConst<56>(s23 ^ D3);
+            uint64_t B20 = rotlConst<62>(s2 ^ D2);
+            uint64_t B21 = rotlConst<55>(s8 ^ D3);
+            uint64_t B22 = rotlConst<39>(s14 ^ D4);
+            uint64_t B23 = rotlConst<41>(s15 ^ D0);
+            uint64_t B24 = rotlConst<2>(s21 ^ D1);
+            //CHI STEP, xor each lane with (its inverted following neighbor) anded with the following following neighbor
+            s0 = B0 ^ (~B1 & B2);
+            s1 = B1 ^ (~B2 & B3);
+            s2 = B2 ^ (~B3 & B4);
+            s3 = B3 ^ (~B4 & B0);
+            s4 = B4 ^ (~B0 & B1);
+            s5 = B5 ^ (~B6 & B7);
+            s6 = B6 ^ (~B7 & B8);
+            s7 = B7 ^ (~B8 & B9);
+            s8 = B8 ^ (~B9 & B5);
+            s9 = B9 ^ (~B5 & B6);
+            s10 = B10 ^ (~B11 & B12);
+            s11 = B11 ^ (~B12 & B13);
+            s12 = B12 ^ (~B13 & B14);
+            s13 = B13 ^ (~B14 & B10);
+            s14 = B14 ^ (~B10 & B11);
+            s15 = B15 ^ (~B16 & B17);
+            s16 = B16 ^ (~B17 & B18);
+            s17 = B17 ^ (~B18 & B19);
+            s18 = B18 ^ (~B19 & B15);
+            s19 = B19 ^ (~B15 & B16);
+            s20 = B20 ^ (~B21 & B22);
+            s21 = B21 ^ (~B22 & B23);
+            s22 = B22 ^ (~B23 & B24);
+            s23 = B23 ^ (~B24 & B20);
+            s24 = B24 ^ (~B20 & B21);
+            //IOTA STEP
+            s0 ^= iotaConstants[round];
+        }
+        state[0] = s0; state[1] = s1; state[2] = s2; state[3] = s3; state[4] = s4; state[5] = s5; state[6] = s6; state[7] = s7; state[8] = s8; state[9] = s9; state[10] = s10; state[11] = s11; state[12] = s12;
+        state[13] = s13; state[14] = s14; state[15] = s15; state[16] = s16; state[17] = s17; state[18] = s18; state[19] = s19; state[20] = s20; state[21] = s21; state[22] = s22; state[23] = s23; state[24] = s24;
+    }
+    //absorbs the input into state in RATE-sized blocks and runs each block through Keccak
+    void Absorb(uint64_t state[25], const uint8_t* input, size_t inputSize) {
+        //reinterpret state as a bytes object so we can modify the bits of state
+        uint8_t* stateBytes = reinterpret_cast<uint8_t*>(state);
+        //while the input is able to be divided into RATE-sized blocks without padding
+        while (inputSize >= RATE) { //technically this program just skips this loop since I just input 4-byte ints but I included this check in case I ever wanted to use it for something else
+            for (size_t i = 0; i < RATE; i++) { //xor the next RATE bytes of input into state
+                stateBytes[i] ^= input[i];
+            } //do the whole Keccak process with the newly updated state
+            KeccakIt(state);
+            input += RATE; //moves the pointer forward because we don't need to read the data again
+            inputSize -= RATE; //removes RATE amount from the input size so at the end we know how much input is left to process
+        } //the last block of data left to process, we put it into a RATE-sized block of 0s
+        uint8_t end[RATE] = {0};
+        memcpy(end, input, inputSize); //put the remaining input into the end block
+        //standardized padding; 6 after the remaining input and 128 at the end
+        end[inputSize] = 6;
+        end[RATE-1] |= 128; //we or it into end to account for the edge case where inputSize == RATE - 1, so the 128 doesn't just overwrite the 6
+        for (size_t i = 0; i < RATE; i++) { //xor the last block into state
+            stateBytes[i] ^= end[i];
+        } //normally there would be a final KeccakIt(state) here but I moved it to Squeeze
+    }
+    //squeezes the output from state
+    void Squeeze(uint64_t state[25], uint8_t* output, size_t outputSize) {
+        //reinterpret state as a bytes object so we can deal with the specific bits rather than pesky 64-bit 8-byte integers
+        uint8_t* stateBytes = reinterpret_cast<uint8_t*>(state);
+
+        //while we still need to write more output
+        while (outputSize > 0) {
+            KeccakIt(state); //Keccak the last block from Absorb on the first go, or to extract different bytes from the sponge on the subsequent goes
+            //if we don't have at least RATE bytes left to output, we only check the remaining outputSize bytes. Otherwise, we keep adding to the output in RATE-sized blocks
+            size_t blockSize = (outputSize < RATE) ? outputSize : RATE;
+            //copy the next blockSize bytes into the output from state
+            memcpy(output, stateBytes, blockSize);
+            outputSize -= blockSize; //subtract from outputSize so we know how many bytes we still need to output
+            output += blockSize; //moves the output pointer forward so we keep writing output in the next loop where we left off in this loop
+        }
+    }
+    //creates a 256-bit 32-byte hash stored as a string using the inputted integer
+    string Hash(const int input) {
+        uint64_t state[25] = {0}; //creates the state array which will be used to process the input
+        //absorb the state into the "sponge", using the data from the input which is byte-ified
+        Absorb(state, reinterpret_cast<const uint8_t*>(&input), sizeof(input));
+        string hash(32, '\0'); //creates the container for the hash bytes, SHA-3 256 creates a 32-byte hash so we make sure the string is that length
+        //extract the hash from the sponge into the hash string (which is byte-ified to allow for the modification of the individual bits)
+        Squeeze(state, reinterpret_cast<uint8_t*>(&hash[0]), hash.size());
+        return hash; //return the generated hash! lets goooooooooooooooooooooooooooooo
+    }
+    //the state a 4-byte int leaves behind after Absorb, without going through Absorb: the int goes in the first 4 bytes, the 6 padding right
+    //after it in byte 4, and the 128 padding in byte RATE-1, which is the top byte of lane 16. Used by the batch hashing so every lane can be set up directly
+    static const int PAD_LANE = (RATE - 1) / 8; //the lane with the final padding bit
+    static uint64_t firstLane(int input) {
+        return (uint64_t)(uint32_t)input | (6ULL << 32);
+    }
+
+    //hashes inputs one at a time, for cpus without AVX2 and for the leftovers that don't fill a whole batch
+    static void HashBatchScalar(const int* inputs, size_t n, digest* output) {
+        for (size_t i = 0; i < n; i++) {
+            output[i] = HashFixed(inputs[i]);
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    //AVX2 version of rotl64, rotates all 4 lanes left by the same amount. AVX2 doesn't have a rotate instruction so we shift both ways and OR them like in rotl64
+    __attribute__((target("avx2"))) static inline __m256i rotl256(__m256i bits, int shift) {
+        if (!shift) { //same edge case as in rotl64
+            return bits;
+        }
+        return _mm256_or_si256(_mm256_sll_epi64(bits, _mm_cvtsi32_si128(shift)), _mm256_srl_epi64(bits, _mm_cvtsi32_si128(64 - shift)));
+    }
+
+    //KeccakIt but every item in state is 4 items from 4 different states, so 4 hashes get keccak'd with the same instructions
+    __attribute__((target("avx2"))) static void KeccakIt4(__m256i state[25]) {
+        for (int round = 0; round < 24; round++) {
+            //THETA STEP, same as KeccakIt
+            __m256i ColCol[5];
+            for (int c = 0; c < 5; c++) {
+                ColCol[c] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(state[c], state[c+5]), _mm256_xor_si256(state[c+10], state[c+15])), state[c+20]);
+            }
+            for (int c = 0; c < 5; c++) {
+                __m256i lr = _mm256_xor_si256(ColCol[(c+4)%5], rotl256(ColCol[(c+1)%5], 1));
+                for (int r = 0; r < 5; r++) {
+                    state[c + 5*r] = _mm256_xor_si256(state[c + 5*r], lr);
+                }
+            }
+            //RHO and PI STEPS, rotate and shuffle in one go
+            __m256i copy[25];
+            for (int i = 0; i < 25; i++) {
+                copy[piShuffle[i]] = rotl256(state[i], rhotations[i]);
+            }
+            //CHI STEP, andnot does (~a & b) in one instruction
+            for (int c = 0; c < 5; c++) {
+                for (int r = 0; r < 5; r++) {
+                    state[c+5*r] = _mm256_xor_si256(copy[c+5*r], _mm256_andnot_si256(copy[(c+1)%5+5*r], copy[(c+2)%5+5*r]));
+                }
+            }
+            //IOTA STEP
+            state[0] = _mm256_xor_si256(state[0], _mm256_set1_epi64x(iotaConstants[round]));
+        }
+    }
+
+    //hashes 4 inputs at a time with AVX2
+    __attribute__((target("avx2"))) static size_t HashBatchAVX2(const int* inputs, size_t n, digest* output) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i state[25];
+            for (int j = 0; j < 25; j++) {
+                state[j] = _mm256_setzero_si256();
+            }
+            state[0] = _mm256_set_epi64x(firstLane(inputs[i+3]), firstLane(inputs[i+2]), firstLane(inputs[i+1]), firstLane(inputs[i]));
+            state[PAD_LANE] = _mm256_set1_epi64x(0x8000000000000000ULL);
+            KeccakIt4(state);
+            alignas(32) uint64_t lanes[4][4]; //the first 4 lanes of each state are the 32 bytes of hash
+            for (int j = 0; j < 4; j++) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[j]), state[j]);
+            }
+            for (int k = 0; k < 4; k++) { //un-interleave them into each hash
+                for (int j = 0; j < 4; j++) {
+                    memcpy(output[i+k].data() + 8*j, &lanes[j][k], 8);
+                }
+            }
+        }
+        return i; //how many were hashed, the rest get done by the scalar version
+    }
+
+    //rotates every lane left by n. The zero masked rotate with every lane kept is the same instruction as the plain one, but the plain one's
+    //intrinsic merges with an undefined register that gcc warns may be uninitialized
+    __attribute__((target("avx512f"))) static inline __m512i rotl512(__m512i x, uint64_t n) {
+        return _mm512_maskz_rolv_epi64(0xFF, x, _mm512_set1_epi64(n));
+    }
+
+    //KeccakIt but with 8 states at once, AVX-512 has a real rotate and a ternary logic instruction that does all of chi's xor-andnot at once
+    __attribute__((target("avx512f"))) static void KeccakIt8(__m512i state[25]) {
+        for (int round = 0; round < 24; round++) {
+            __m512i ColCol[5];
+            for (int c = 0; c < 5; c++) { //0x96 is the truth table for a^b^c
+                ColCol[c] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(state[c], state[c+5], state[c+10], 0x96), state[c+15], state[c+20], 0x96);
+            }
+            for (int c = 0; c < 5; c++) {
+                __m512i lr = _mm512_xor_si512(ColCol[(c+4)%5], rotl512(ColCol[(c+1)%5], 1));
+                for (int r = 0; r < 5; r++) {
+                    state[c + 5*r] = _mm512_xor_si512(state[c + 5*r], lr);
+                }
+            }
+            __m512i copy[25];
+            for (int i = 0; i < 25; i++) {
+                copy[piShuffle[i]] = rotl512(state[i], rhotations[i]);
+            }
+            for (int c = 0; c < 5; c++) { //0xD2 is the truth table for a^(~b&c)
+                for (int r = 0; r < 5; r++) {
+                    state[c+5*r] = _mm512_ternarylogic_epi64(copy[c+5*r], copy[(c+1)%5+5*r], copy[(c+2)%5+5*r], 0xD2);
+                }
+            }
+            state[0] = _mm512_xor_si512(state[0], _mm512_set1_epi64(iotaConstants[round]));
+        }
+    }
+
+    //hashes 8 inputs at a time with AVX-512
+    __attribute__((target("avx512f"))) static size_t HashBatchAVX512(const int* inputs, size_t n, digest* output) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i state[25];
+            for (int j = 0; j < 25; j++) {
+                state[j] = _mm512_setzero_si512();
+            }
+            state[0] = _mm512_set_epi64(firstLane(inputs[i+7]), firstLane(inputs[i+6]), firstLane(inputs[i+5]), firstLane(inputs[i+4]),
+                                        firstLane(inputs[i+3]), firstLane(inputs[i+2]), firstLane(inputs[i+1]), firstLane(inputs[i]));
+            state[PAD_LANE] = _mm512_set1_epi64(0x8000000000000000ULL);
+            KeccakIt8(state);
+            alignas(64) uint64_t lanes[4][8];
+            for (int j = 0; j < 4; j++) {
+                _mm512_store_si512(lanes[j], state[j]);
+            }
+            for (int k = 0; k < 8; k++) {
+                for (int j = 0; j < 4; j++) {
+                    memcpy(output[i+k].data() + 8*j, &lanes[j][k], 8);
+                }
+            }
+        }
+        return i;
+    }
+#endif
+
+    //hashes n integers into output, picking the widest SIMD the cpu has (checked once) and doing the leftovers one at a time
+    void HashBatch(const int* inputs, size_t n, digest* output) {
+        size_t done = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        static const bool avx512 = __builtin_cpu_supports("avx512f");
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        if (avx512) {
+            done = HashBatchAVX512(inputs, n, output);
+        } else if (avx2) {
+            done = HashBatchAVX2(inputs, n, output);
+        }
+#endif
+        HashBatchScalar(inputs + done, n - done, output + done);
+    }
+    //folds the hash into one 64-bit int by xoring it together in 8-byte chunks, based on Absorb() above, so the tables only have to mask it to get an index
+    uint64_t Fold(const digest& hash) {
+        uint64_t folded = 0; //create the folded hash
+        const uint8_t* hashBytes = hash.data();
+        size_t hashSize = hash.size(); //the full size of the hash
+        //the amount of bytes the folded hash takes up (the size of size!)
+        const size_t sizesize = sizeof(uint64_t);
+
+        while (hashSize > 0) { //xors the hash into the folded hash in size-sized chunks (so we don't just waste the rest of the hash we worked so hard to make)
+            uint64_t hashChunk = 0; //creates an empty chunk to memcpy into
+            size_t chunkSize = hashSize < sizesize ? hashSize : sizesize; //get the size of the chunk (sizesize for everything except the end of the hash, so we don't go over the end of hash if hashSize%sizesize != 0)
+            memcpy(&hashChunk, hashBytes, chunkSize); //get the chunkSize-sized chunk of the hash
+            folded ^= hashChunk; //xor the chunk into the folded hash
+            hashBytes += chunkSize; //advance the hash pointer forward so we read the next chunk next loop
+            hashSize -= chunkSize; //subtract from the hashSize so we know how big the last chunk is when we get there
+        } //xors the top half into the bottom half so that both halves matter equally in the final mask, because otherwise the top half wouldn't matter as much
+        folded ^= folded >> (sizesize*4 + 1); //we use that amount cause bitshift uses bit amounts, and 8 bits = 1 byte, and we want to shift it by half, so we multiply by 4, and then we add one to reduce symmetry. sizesize*4+1 is computed before >>
+        //mix it with Knuth's constant, well known for de-linearizing hashes (so more random, less collisions). SHA-3 is very good at hashing, but since we fold it so much a lot of the entropy is gone, so we also do this
+        folded *= 11400714819323198485ULL;
+        return folded;
+    }
 }
\ No newline at end of file
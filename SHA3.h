@@ -1,19 +1,48 @@
-//header file for the SHA-3 hash algorithm
-
-#ifndef SHA_3
-#define SHA_3
-
-#include <cstdint> //this is a very low-level hash algorithm for efficiency, which is why we use special variable types (these include those types)
-#include <cstddef>
-#include <string>
-
-namespace SHA3 {
-    uint64_t rotl64(uint64_t bits, int shift); //rotates the given bits left by "shift" spaces
-    void KeccakIt(uint64_t state[25]); //scrambles the given state 24 times in a 5x5 array, but a 25 array is used instead cause its slightly more efficient
-    //SHA-3 uses a "sponge" so we use sponge terminology
-    void Absorb(uint64_t state[25], const uint8_t* data, size_t dataSize); //handles the given data in blocks, which it XORs into state, then scrambles it
-    void Squeeze(uint64_t state[25], uint8_t* output, size_t outputSize); //extracts the processed data from state
-    std::string Hash(const int input); //uses SHA-3 to do stuff to the given string and return a hash based on that
-}
-
+//header file for the SHA-3 hash algorithm
+
+#ifndef SHA_3
+#define SHA_3
+
+#include <cstdint> //this is a very low-level hash algorithm for efficiency, which is why we use special variable types (these include those types)
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <array>
+#include <type_traits>
+
+namespace SHA3 {
+    typedef std::array<uint8_t, 32> digest; //a SHA-3 256 hash, 32 bytes that live right where they're declared instead of on the heap
+    //the rate used by SHA-3 256 is standardized as 136. If I ever wanted to change SHA-3s I need to change the rate here
+    constexpr size_t RATE = 136;
+
+    uint64_t rotl64(uint64_t bits, int shift); //rotates the given bits left by "shift" spaces
+    void KeccakIt(uint64_t state[25]); //scrambles the given state 24 times in a 5x5 array, but a 25 array is used instead cause its slightly more efficient
+    void KeccakUnrolled(uint64_t state[25]); //same as KeccakIt, but with each round written out step by step with constant indices and rotations
+    //SHA-3 uses a "sponge" so we use sponge terminology
+    void Absorb(uint64_t state[25], const uint8_t* data, size_t dataSize); //handles the given data in blocks, which it XORs into state, then scrambles it
+    void Squeeze(uint64_t state[25], uint8_t* output, size_t outputSize); //extracts the processed data from state
+    std::string Hash(const int input); //uses SHA-3 to do stuff to the given string and return a hash based on that
+    void HashBatch(const int* inputs, size_t n, digest* output); //hashes n integers at once, running 8 or 4 keccaks in parallel with AVX-512 or AVX2 if the cpu has them, gives the exact same hashes as Hash
+    uint64_t Fold(const digest& hash); //folds the hash into one well-mixed 64-bit int, which the tables then turn into an index
+
+    //hashes an input whose size is known at compile time, like an int. It fits in one block, so instead of Absorb zero-filling and xoring a whole
+    //RATE-sized end block, the input is copied straight into state and the padding goes into lanes that are worked out at compile time.
+    //Gives the exact same hash as Absorb + Squeeze would, but in a digest instead of a heap string
+    template <class T>
+    digest HashFixed(const T& input) {
+        static_assert(std::is_trivially_copyable<T>::value, "HashFixed hashes the raw bytes of the input");
+        static_assert(sizeof(T) < RATE, "HashFixed only works for inputs that fit in one block with room for the padding");
+        constexpr size_t padLane = sizeof(T) / 8; //the 6 goes right after the input
+        constexpr uint64_t padBits = 6ULL << (8 * (sizeof(T) % 8));
+        uint64_t state[25] = {0};
+        memcpy(state, &input, sizeof(T));
+        state[padLane] ^= padBits;
+        state[(RATE - 1) / 8] ^= 0x8000000000000000ULL; //and the 128 goes in the last byte of the block
+        KeccakUnrolled(state);
+        digest hash;
+        memcpy(hash.data(), state, hash.size()); //SHA-3 256 only needs the first 32 bytes, which is less than RATE so one keccak is enough
+        return hash;
+    }
+}
+
 #endif
\ No newline at end of file
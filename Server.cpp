@@ -0,0 +1,228 @@
+//implementation file for the server
+
+#include "Server.h"
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+int Server::wakeup[2] = {-1, -1};
+
+Server::Server() : listener(-1), epoll(-1) {}
+
+Server::~Server() {
+    for (Connection* connection : connections) {
+        if (connection != NULL) {
+            ::close(connection->fd);
+            delete connection;
+        }
+    }
+    if (listener >= 0) {
+        ::close(listener);
+        unlink(path.c_str()); //so the next server doesn't find a dead socket there
+    }
+    if (epoll >= 0) {
+        ::close(epoll);
+    }
+}
+
+bool Server::listen(const string& _path, string& error) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (_path.size() >= sizeof(address.sun_path)) { //Unix socket paths are capped at about a hundred characters
+        error = "the path is too long";
+        return false;
+    }
+    strcpy(address.sun_path, _path.c_str());
+
+    struct stat info;
+    if (lstat(_path.c_str(), &info) == 0) { //something's already there, which is fine if it's a socket nobody is listening on anymore
+        if (!S_ISSOCK(info.st_mode)) {
+            error = "there's already a file there";
+            return false;
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool alive = probe >= 0 && connect(probe, (sockaddr*)&address, sizeof(address)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (alive) {
+            error = "another server is already using it";
+            return false;
+        }
+        unlink(_path.c_str());
+    }
+
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (epoll < 0 || listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0) {
+        error = strerror(errno);
+        if (listener >= 0) {
+            ::close(listener);
+            listener = -1; //so the destructor doesn't remove a socket file that isn't ours
+        }
+        return false;
+    }
+    path = _path;
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    if (::listen(listener, SOMAXCONN) != 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) != 0) {
+        error = strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void Server::stop(int) {
+    int saved = errno; //so whatever the signal interrupted doesn't see a changed errno
+    char byte = 0;
+    if (::write(wakeup[1], &byte, 1) < 0) {} //if the pipe is full we're already stopping anyway
+    errno = saved;
+}
+
+void Server::run(Handler handle) {
+    if (listener < 0 || pipe2(wakeup, O_NONBLOCK | O_CLOEXEC) != 0) {
+        return;
+    }
+    struct sigaction action, oldInterrupt, oldTerminate;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &oldInterrupt);
+    sigaction(SIGTERM, &action, &oldTerminate);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = wakeup[0];
+    epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup[0], &event);
+
+    epoll_event events[256];
+    for (bool running = true; running;) {
+        int ready = epoll_wait(epoll, events, 256, -1);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wakeup[0]) {
+                running = false;
+            } else if (fd == listener) {
+                accept();
+            } else if ((size_t)fd < connections.size() && connections[fd] != NULL) { //it could've been closed by an earlier event
+                if (events[i].events & EPOLLIN) {
+                    read(connections[fd], handle);
+                } else {
+                    write(connections[fd]); //it can take more answers, or it hung up and the send finds out
+                }
+            }
+        }
+    }
+
+    sigaction(SIGINT, &oldInterrupt, NULL); //a second Ctrl+C while we're shutting down works like normal again
+    sigaction(SIGTERM, &oldTerminate, NULL);
+    epoll_ctl(epoll, EPOLL_CTL_DEL, wakeup[0], NULL);
+    ::close(wakeup[0]);
+    ::close(wakeup[1]);
+    wakeup[0] = wakeup[1] = -1;
+}
+
+void Server::accept() {
+    for (;;) { //level triggered, but taking them all now saves a trip through epoll for each one
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return; //either nobody else is waiting, or we're out of file descriptors and they wait until someone leaves
+        }
+        if ((size_t)fd >= connections.size()) {
+            connections.resize(fd + 1, NULL);
+        }
+        connections[fd] = new Connection(fd);
+        watch(connections[fd]);
+    }
+}
+
+void Server::read(Connection* connection, Handler& handle) {
+    static char chunk[READ_SIZE]; //static since there's only ever one read at a time
+    ssize_t got = ::read(connection->fd, chunk, READ_SIZE);
+    if (got < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+    if (got <= 0) { //it hung up (or broke), but it might've only shut down its sending side and still be waiting for answers
+        connection->closing = true;
+    } else {
+        connection->input.append(chunk, got);
+    }
+
+    string& input = connection->input;
+    string line;
+    size_t start = 0;
+    for (size_t end; (end = input.find('\n', start)) != string::npos; start = end + 1) { //answers every whole line, the rest waits for more
+        line.assign(input, start, end - start);
+        if (!handle(line, ++connection->lines, connection->answers)) { //QUIT, nothing after it gets answered
+            connection->closing = true;
+            start = input.size();
+            break;
+        }
+    }
+    input.erase(0, start);
+    if (input.size() > MAX_LINE) {
+        close(connection);
+        return;
+    }
+    write(connection);
+}
+
+void Server::write(Connection* connection) {
+    string& answers = connection->answers.text();
+    size_t sent = 0;
+    while (sent < answers.size()) {
+        ssize_t put = send(connection->fd, answers.data() + sent, answers.size() - sent, MSG_NOSIGNAL); //MSG_NOSIGNAL so a hung up client doesn't kill us with SIGPIPE
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put < 0 && errno != EAGAIN) { //it's gone, nobody to send the rest to
+            close(connection);
+            return;
+        }
+        if (put < 0) { //its socket is full, the rest goes once epoll says it has room
+            break;
+        }
+        sent += put;
+    }
+    answers.erase(0, sent);
+    if (answers.empty() && connection->closing) {
+        close(connection);
+        return;
+    }
+    watch(connection);
+}
+
+void Server::watch(Connection* connection) {
+    unsigned events = 0;
+    if (!connection->closing && connection->answers.text().size() < MAX_UNSENT) { //a client that doesn't read its answers doesn't get more
+        events |= EPOLLIN;
+    }
+    if (!connection->answers.text().empty()) {
+        events |= EPOLLOUT;
+    }
+    if (events == connection->events) { //nothing changed, which is almost always, so skip the system call
+        return;
+    }
+    epoll_event event;
+    event.events = events;
+    event.data.fd = connection->fd;
+    epoll_ctl(epoll, connection->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, connection->fd, &event);
+    connection->events = events;
+}
+
+void Server::close(Connection* connection) {
+    connections[connection->fd] = NULL;
+    ::close(connection->fd); //also takes it out of epoll
+    delete connection;
+}
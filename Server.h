@@ -0,0 +1,58 @@
+//header file for the server, which lets other processes on the same machine use the table over a Unix socket instead of each building their own.
+//The protocol is the batch mode one: a client sends commands one per line and gets one answer line back per command, in the same order, so it
+//can send a whole bunch of commands at once and read all the answers after (pipelining) instead of waiting for every single one. Everything runs
+//on one thread with epoll, so a thousand clients cost a thousand sockets and buffers instead of a thousand threads, and the table never gets
+//touched by two commands at the same time. Every connection gets all the commands it sent answered before anything is sent back, so a
+//pipelined batch costs one read and one write no matter how many commands are in it
+
+#ifndef SERVER
+#define SERVER
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <functional>
+#include "BatchOutput.h"
+
+class Server {
+public:
+    //runs one command line, writing its answer into out. lineNumber counts the lines of that connection. Returns false to close the connection
+    typedef std::function<bool(const std::string& line, long long lineNumber, BatchOutput& out)> Handler;
+    static const size_t READ_SIZE = 64 << 10; //how much gets read from a connection at a time
+    static const size_t MAX_LINE = 1 << 20; //a line longer than this gets the connection closed, so a client can't make us buffer forever
+    static const size_t MAX_UNSENT = 4 << 20; //once a connection has this many bytes of answers it isn't reading, we stop reading its commands
+
+    Server();
+    ~Server(); //closes every connection and removes the socket file
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    //starts listening on a Unix socket at the given path (replacing whatever socket was left there), returns false with the reason in error if it can't
+    bool listen(const std::string& path, std::string& error);
+    //answers every connection's commands with handle until the process gets SIGINT or SIGTERM
+    void run(Handler handle);
+private:
+    struct Connection {
+        Connection(int _fd) : fd(_fd), answers(NULL), lines(0), events(0), closing(false) {}
+        int fd;
+        std::string input; //what's been read but isn't a whole line yet
+        BatchOutput answers; //what hasn't been sent yet, never written anywhere by itself
+        long long lines; //how many lines it's sent so far
+        unsigned events; //what epoll is watching it for
+        bool closing; //it said QUIT or hung up, so it gets closed once its answers are sent
+    };
+
+    void accept(); //takes every waiting connection
+    void read(Connection* connection, Handler& handle); //reads what the connection sent, answers every whole line in it and sends the answers
+    void write(Connection* connection); //sends as much of the connection's answers as it'll take, closes it if it's done
+    void watch(Connection* connection); //makes epoll watch for whatever the connection needs next
+    void close(Connection* connection);
+    static void stop(int signal); //the SIGINT and SIGTERM handler, wakes run up through the pipe
+
+    std::string path; //the socket file, removed again when we're done
+    int listener; //the listening socket, -1 if we aren't listening
+    int epoll;
+    std::vector<Connection*> connections; //indexed by their socket, since those are small numbers
+    static int wakeup[2]; //the pipe stop writes into, since a signal handler can't do much else safely
+};
+#endif
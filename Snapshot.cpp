@@ -0,0 +1,159 @@
+//implementation file for snapshots, everything that doesn't depend on the table type
+
+#include "Snapshot.h"
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+namespace Snapshot {
+    MappedFile::MappedFile(const string& path) : bytes(NULL), length(0) { //maps the whole file, or leaves bytes NULL if anything goes wrong
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                bytes = static_cast<const char*>(mapping);
+                length = info.st_size;
+                madvise(mapping, length, MADV_SEQUENTIAL); //loading goes through every column front to back, so the kernel can read ahead
+            }
+        }
+        close(fd); //the mapping stays valid without the file being open
+    }
+    MappedFile::~MappedFile() {
+        if (bytes != NULL) {
+            munmap(const_cast<char*>(bytes), length);
+        }
+    }
+
+    //whether a column of count things of the given size starting at offset fits in the file
+    static bool fits(const MappedFile& file, uint64_t offset, uint64_t count, size_t size) {
+        return offset % 8 == 0 && offset <= file.size() && count <= (file.size() - offset) / size;
+    }
+
+    const Header* Open(const MappedFile& file, string& error) {
+        if (!file.ok()) {
+            error = "couldn't open the file";
+            return NULL;
+        }
+        const Header* header = reinterpret_cast<const Header*>(file.data());
+        if (file.size() < sizeof(Header) || memcmp(header->magic, MAGIC, sizeof(MAGIC))) {
+            error = "it isn't a snapshot";
+            return NULL;
+        }
+        if (header->version != VERSION) {
+            error = "it's from a different version (" + to_string(header->version) + ")";
+            return NULL;
+        }
+        if (header->byteOrder != ENDIANNESS) {
+            error = "it was saved on a machine with a different byte order";
+            return NULL;
+        }
+        if (header->count > SIZE_MAX / 2 || !fits(file, header->idsOffset, header->count, sizeof(int)) ||
+            !fits(file, header->hashesOffset, header->count, sizeof(uint64_t)) || !fits(file, header->gpasOffset, header->count, sizeof(float)) ||
+            !fits(file, header->namesOffset, 2 * header->count + 1, sizeof(uint64_t)) || !fits(file, header->blobOffset, header->blobSize, 1)) {
+            error = "it's cut off or corrupted";
+            return NULL;
+        }
+        //the name offsets are the only thing that could send LOAD reading outside the file, so they get checked one by one
+        const uint64_t* names = reinterpret_cast<const uint64_t*>(file.data() + header->namesOffset);
+        for (uint64_t i = 0; i < 2 * header->count; i++) {
+            if (names[i] > names[i + 1]) {
+                error = "it's corrupted";
+                return NULL;
+            }
+        }
+        if (names[0] != 0 || names[2 * header->count] != header->blobSize) {
+            error = "it's corrupted";
+            return NULL;
+        }
+        return header;
+    }
+
+    //writes all the bytes, write can stop partway for big ones. Returns false if it fails
+    static bool writeAll(int fd, const char* data, uint64_t size) {
+        while (size > 0) {
+            ssize_t written = write(fd, data, size);
+            if (written < 0) {
+                return false;
+            }
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    //writes the column and pads it with zeroes up to a multiple of 8 bytes, adding to offset as it goes. ok turns false if anything fails
+    static void writeColumn(int fd, const void* data, uint64_t size, uint64_t& offset, bool& ok) {
+        static const char zeroes[8] = {0};
+        ok = ok && writeAll(fd, static_cast<const char*>(data), size) && writeAll(fd, zeroes, (8 - size % 8) % 8);
+        offset += (size + 7) / 8 * 8;
+    }
+
+    bool SyncDirectory(const string& path) {
+        size_t slash = path.rfind('/');
+        string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            return false;
+        }
+        bool synced = fsync(fd) == 0;
+        close(fd);
+        return synced;
+    }
+
+    bool Write(const string& path, const Columns& columns, string& error) {
+        const vector<int>& ids = columns.ids;
+        const vector<uint64_t>& hashes = columns.hashes;
+        const vector<float>& gpas = columns.gpas;
+        const vector<uint64_t>& names = columns.names;
+        const string& blob = columns.blob;
+        Header header;
+        memset(&header, 0, sizeof(header)); //so the padding and the rest of the hasher name are zeroes instead of garbage
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byteOrder = ENDIANNESS;
+        strncpy(header.hasher, columns.hasher.c_str(), sizeof(header.hasher) - 1);
+        header.count = ids.size();
+        header.nextID = columns.nextID;
+        header.generation = columns.generation;
+        header.idsOffset = (sizeof(Header) + 7) / 8 * 8; //the columns come right after the header, each one 8 byte aligned
+        header.hashesOffset = header.idsOffset + (ids.size() * sizeof(int) + 7) / 8 * 8;
+        header.gpasOffset = header.hashesOffset + hashes.size() * sizeof(uint64_t);
+        header.namesOffset = header.gpasOffset + (gpas.size() * sizeof(float) + 7) / 8 * 8;
+        header.blobOffset = header.namesOffset + names.size() * sizeof(uint64_t);
+        header.blobSize = blob.size();
+
+        string temporary = path + ".tmp";
+        int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            error = "couldn't create " + temporary;
+            return false;
+        }
+        uint64_t offset = 0;
+        bool ok = true;
+        writeColumn(fd, &header, sizeof(header), offset, ok);
+        writeColumn(fd, ids.data(), ids.size() * sizeof(int), offset, ok);
+        writeColumn(fd, hashes.data(), hashes.size() * sizeof(uint64_t), offset, ok);
+        writeColumn(fd, gpas.data(), gpas.size() * sizeof(float), offset, ok);
+        writeColumn(fd, names.data(), names.size() * sizeof(uint64_t), offset, ok);
+        writeColumn(fd, blob.data(), blob.size(), offset, ok);
+        ok = fsync(fd) == 0 && ok; //all on disk before the rename, or a power loss could leave the new name on an empty file
+        ok = close(fd) == 0 && ok;
+        if (!ok || rename(temporary.c_str(), path.c_str())) { //the rename swaps the new snapshot in all at once
+            error = "couldn't write " + path;
+            remove(temporary.c_str());
+            return false;
+        }
+        if (!SyncDirectory(path)) { //the rename only sticks once the directory is on disk too
+            error = "couldn't sync the directory of " + path;
+            return false;
+        }
+        return true;
+    }
+}
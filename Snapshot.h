@@ -0,0 +1,146 @@
+//header file for snapshots, which are binary files with the whole table in them so the database can be SAVEd and LOADed back later.
+//The file is laid out in columns (all the IDs, then all the hashes, then all the GPAs, then where each name starts, then all the names)
+//so LOAD can mmap it and hand the ID and hash columns straight to the table's bulkInsert without reading them into anything first. The
+//hashes only get reused if the snapshot was saved with the same hasher, otherwise the keys just get hashed again
+
+#ifndef SNAPSHOT
+#define SNAPSHOT
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Student.h"
+
+namespace Snapshot {
+    const char MAGIC[8] = {'H', 'A', 'R', 'R', 'Y', 'D', 'B', '\0'}; //the first bytes of every snapshot, so we don't try to load random files
+    const uint32_t VERSION = 2; //goes up whenever the layout changes, so old files get rejected instead of misread
+    const uint32_t ENDIANNESS = 0x01020304; //reads back differently on a machine with the other byte order
+
+    struct Header { //the start of the file, the offsets are in bytes from the start of the file and all multiples of 8
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        char hasher[16]; //the name of the hasher the hashes came from
+        uint64_t count; //how many students there are
+        int64_t nextID; //the ID GENERATE was going to use next
+        uint64_t idsOffset; //count ints
+        uint64_t hashesOffset; //count 64-bit hashes
+        uint64_t gpasOffset; //count floats
+        uint64_t namesOffset; //2 * count + 1 offsets into the name bytes, student i's first name goes from [2i] to [2i+1] and their last name to [2i+2]
+        uint64_t blobOffset; //all the names one after the other, no null characters
+        uint64_t blobSize;
+        uint32_t generation; //which compaction of a journal wrote it (see Journal.h), 0 for SAVEd ones
+        uint32_t unused;
+    };
+
+    //a whole file mapped into memory read only, the pages only get read in from disk when something touches them
+    class MappedFile {
+    public:
+        MappedFile(const std::string& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool ok() const { //whether the file got mapped
+            return bytes != NULL;
+        }
+        const char* data() const {
+            return bytes;
+        }
+        size_t size() const {
+            return length;
+        }
+    private:
+        const char* bytes; //the start of the mapping, NULL if mapping failed
+        size_t length;
+    };
+
+    //everything that goes in a snapshot's columns, gathered from a table but not written yet
+    struct Columns {
+        std::string hasher; //the name of the hasher the hashes came from
+        int nextID;
+        uint32_t generation;
+        std::vector<int> ids;
+        std::vector<uint64_t> hashes;
+        std::vector<float> gpas;
+        std::vector<uint64_t> names;
+        std::string blob;
+    };
+
+    //checks that the mapped file is a snapshot we can read and returns its header, or NULL with the reason in error
+    const Header* Open(const MappedFile& file, std::string& error);
+    //writes the columns into a snapshot at the given path, through a temporary file so a crash halfway doesn't wreck the last snapshot. The
+    //file is fsynced before it gets renamed over the old one and the directory after, so once this returns the snapshot survives a power loss
+    bool Write(const std::string& path, const Columns& columns, std::string& error);
+    //fsyncs the directory the file at the given path is in, which is what makes a rename, a new file or a deleted one in it stick
+    bool SyncDirectory(const std::string& path);
+
+    //copies every student in the table into columns, which can then be written without the table (even on another thread). It goes through
+    //the table with scan, a batch at a time, so nothing changes in between and every student gets copied exactly once
+    template <class Table>
+    void Collect(Table& table, int nextID, Columns& columns) {
+        columns.hasher = Table::hasher_type::name();
+        columns.nextID = nextID;
+        columns.generation = 0; //the journal sets its own when it compacts
+        columns.ids.reserve(table.size());
+        columns.hashes.reserve(table.size());
+        columns.gpas.reserve(table.size());
+        columns.names.reserve(2 * table.size() + 1);
+        size_t cursor = 0;
+        do {
+            cursor = table.scan(cursor, 4096, [&](int id, Student& student, uint64_t hash) {
+                columns.ids.push_back(id);
+                columns.hashes.push_back(hash); //the stored hash, so LOAD can skip hashing if the hasher is the same
+                columns.gpas.push_back(student.getGPA());
+                columns.names.push_back(columns.blob.size());
+                columns.blob += student.getName(0);
+                columns.names.push_back(columns.blob.size());
+                columns.blob += student.getName(1);
+            });
+        } while (cursor != 0);
+        columns.names.push_back(columns.blob.size()); //where the last last name ends
+    }
+
+    //saves every student in the table into a snapshot at the given path, returns false with the reason in error if it couldn't
+    template <class Table>
+    bool Save(Table& table, const std::string& path, int nextID, std::string& error) {
+        Columns columns;
+        Collect(table, nextID, columns);
+        return Write(path, columns, error);
+    }
+
+    //replaces everything in the table with the students in the snapshot at the given path, and moves nextID past every ID the snapshot
+    //had given out. Returns false with the reason in error (leaving the table alone) if it couldn't. generation gets the snapshot's, if it's given
+    template <class Table>
+    bool Load(Table& table, const std::string& path, int& nextID, std::string& error, uint32_t* generation = NULL) {
+        MappedFile file(path);
+        const Header* header = Open(file, error);
+        if (header == NULL) {
+            return false;
+        }
+        const int* ids = reinterpret_cast<const int*>(file.data() + header->idsOffset);
+        const uint64_t* hashes = reinterpret_cast<const uint64_t*>(file.data() + header->hashesOffset);
+        const float* gpas = reinterpret_cast<const float*>(file.data() + header->gpasOffset);
+        const uint64_t* names = reinterpret_cast<const uint64_t*>(file.data() + header->namesOffset);
+        const char* blob = file.data() + header->blobOffset;
+        bool sameHasher = strncmp(header->hasher, Table::hasher_type::name(), sizeof(header->hasher)) == 0;
+
+        table.clear();
+        table.bulkInsert(ids, sameHasher ? hashes : NULL, header->count, [&](size_t i) { //the students are the only thing that gets built
+            std::string_view firstname(blob + names[2 * i], names[2 * i + 1] - names[2 * i]); //straight out of the file into the name pool
+            std::string_view lastname(blob + names[2 * i + 1], names[2 * i + 2] - names[2 * i + 1]);
+            return Student(firstname, lastname, ids[i], gpas[i]);
+        });
+        if (header->nextID > nextID) {
+            nextID = header->nextID;
+        }
+        if (generation != NULL) {
+            *generation = header->generation;
+        }
+        return true;
+    }
+}
+#endif
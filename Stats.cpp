@@ -0,0 +1,65 @@
+//implementation file for the table statistics, just the part that turns them into text
+
+#include "Stats.h"
+#include <cstdio>
+using namespace std;
+
+//formats a number with the given amount of decimals
+static string decimal(double value, int decimals) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    return text;
+}
+
+vector<pair<string, string> > TableStats::fields(const TableShape& shape) const {
+    vector<pair<string, string> > out;
+    out.push_back(make_pair("entries", to_string(shape.entries)));
+    out.push_back(make_pair("slots", to_string(shape.slots)));
+    out.push_back(make_pair("load_factor", decimal(shape.slots ? (double)shape.entries / shape.slots : 0, 3)));
+    out.push_back(make_pair("bytes", to_string(shape.bytes)));
+    out.push_back(make_pair("bytes_per_record", decimal(shape.entries ? (double)shape.bytes / shape.entries : 0, 1)));
+    for (size_t i = 0; i < shape.lengths.size(); i++) { //the last one is that length or longer
+        out.push_back(make_pair(string(shape.lengthName) + "_" + to_string(i) + (i + 1 == shape.lengths.size() ? "+" : ""), to_string(shape.lengths[i])));
+    }
+    out.insert(out.end(), shape.extra.begin(), shape.extra.end());
+    out.push_back(make_pair("counters", ENABLED ? "on" : "off"));
+#if HARRY_STATS
+    uint64_t lookups = 0;
+    uint64_t probeTotal = longProbes;
+    for (size_t i = 0; i < BINS; i++) {
+        lookups += probeCounts[i];
+        probeTotal += i < BINS - 1 ? i * probeCounts[i] : 0;
+    }
+    out.push_back(make_pair("lookups", to_string(lookups)));
+    out.push_back(make_pair("probes_per_lookup", decimal(lookups ? (double)probeTotal / lookups : 0, 3)));
+    for (size_t i = 0; i < BINS; i++) {
+        out.push_back(make_pair("probes_" + to_string(i) + (i + 1 == BINS ? "+" : ""), to_string(probeCounts[i])));
+    }
+    out.push_back(make_pair("inserts", to_string(inserts)));
+    out.push_back(make_pair("bulk_inserts", to_string(bulkInserts)));
+    out.push_back(make_pair("erases", to_string(erases)));
+    out.push_back(make_pair("resizes", to_string(resizes)));
+    out.push_back(make_pair("doublings", to_string(doublings)));
+    out.push_back(make_pair("max_doublings_per_resize", to_string(maxDoublings)));
+    out.push_back(make_pair("halvings", to_string(halvings)));
+    out.push_back(make_pair("bytes_reclaimed", to_string(reclaimedBytes)));
+    //a full walk (PRINT, AVERAGE without the column, the shape above) goes through every slot, so this is how much faster it is now than
+    //it would be if the table had stayed as big as it ever got
+    size_t peak = peakSlots > shape.slots ? peakSlots : shape.slots;
+    out.push_back(make_pair("peak_slots", to_string(peak)));
+    out.push_back(make_pair("scan_speedup", decimal(shape.slots ? (double)peak / shape.slots : 1, 2)));
+    out.push_back(make_pair("resize_ms", decimal(resizeNanos / 1e6, 3)));
+    out.push_back(make_pair("max_resize_ms", decimal(maxResizeNanos / 1e6, 3)));
+    //the shares are of the time spent hashing and inserting, per operation, so they still make sense when there were more finds than inserts
+    double hashAverage = hashSamples ? (double)hashNanos / hashSamples : 0;
+    double insertAverage = insertSamples ? (double)insertNanos / insertSamples : 0;
+    double allocAverage = insertSamples ? (double)allocNanos / insertSamples : 0;
+    double total = hashAverage + insertAverage;
+    out.push_back(make_pair("hash_ns", decimal(hashAverage, 1)));
+    out.push_back(make_pair("insert_ns", decimal(insertAverage, 1)));
+    out.push_back(make_pair("alloc_ns", decimal(allocAverage, 1)));
+    out.push_back(make_pair("hash_share", decimal(total > 0 ? hashAverage / total : 0, 3)));
+    out.push_back(make_pair("alloc_share", decimal(total > 0 ? allocAverage / total : 0, 3)));
+#endif
+    return out;
+}
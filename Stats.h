@@ -0,0 +1,189 @@
+//header file for the table statistics, the counters the tables keep on their hot paths so the STATS command can say what's going on inside
+//them: how long lookups probe, how often and for how long the table resizes, and where the time of an insert goes. Counting is just a few
+//adds, but timing isn't free, so only one in every SAMPLE_EVERY hashes and inserts gets timed and the averages come from those.
+//Everything gets compiled out when HARRY_STATS is 0 (make STATS=0): the methods are still there but empty, so the tables don't need a single
+//#if of their own and the compiler throws the calls away
+
+#ifndef STATS
+#define STATS
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef HARRY_STATS
+#define HARRY_STATS 1 //on unless the build turns it off
+#endif
+
+//how a table looks right now, gathered by walking it when someone asks, so it costs nothing the rest of the time
+struct TableShape {
+    size_t entries;
+    size_t slots; //buckets of the chained table, slots of the flat one
+    size_t bytes; //everything the table itself has allocated, and for the StudentTable the name pool the students' names are in too
+    const char* lengthName; //what lengths counts, "chain" or "probe"
+    std::vector<size_t> lengths; //for the chained table how many buckets have a chain of each length, for the flat one how many entries are that many groups from home
+    std::vector<std::pair<std::string, std::string> > extra; //anything else whatever wraps the table wants to report, like the StudentTable's filter
+};
+
+class TableStats {
+public:
+    static const size_t BINS = 8; //histograms go 0 to 6 and then 7 or more
+    static const uint32_t SAMPLE_EVERY = 64; //one of every this many hashes and inserts gets timed
+
+    //times something if it was started with true, otherwise does nothing at all
+    class Timer {
+    public:
+#if HARRY_STATS
+        Timer(bool on) : start(on ? now() : 0) {}
+        bool running() const {
+            return start != 0;
+        }
+        uint64_t elapsed() const { //nanoseconds since it started
+            return running() ? now() - start : 0;
+        }
+    private:
+        uint64_t start; //0 if we aren't timing
+#else
+        Timer(bool) {}
+        bool running() const {
+            return false;
+        }
+        uint64_t elapsed() const {
+            return 0;
+        }
+#endif
+    };
+
+    TableStats() {
+        memset(this, 0, sizeof(*this)); //nothing but counters in here
+    }
+
+#if HARRY_STATS
+    static const bool ENABLED = true;
+    static uint64_t now() { //nanoseconds on the steady clock
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool sampleHash() { //whether to time this hash
+        return ++hashTicks % SAMPLE_EVERY == 0;
+    }
+    void hashed(const Timer& timer, size_t keys = 1) { //keys is how many got hashed at once
+        hashSamples += keys;
+        hashNanos += timer.elapsed();
+    }
+    bool sampleInsert() { //whether to time this insert
+        return ++insertTicks % SAMPLE_EVERY == 0;
+    }
+    void allocated(const Timer& timer) { //the part of a timed insert that got the node or slot and built the entry in it
+        allocNanos += timer.elapsed();
+    }
+    void inserted(const Timer& timer) {
+        inserts++;
+        if (timer.running()) {
+            insertSamples++;
+            insertNanos += timer.elapsed();
+        }
+    }
+    void bulkInserted(size_t amount) {
+        bulkInserts += amount;
+    }
+    void erased() {
+        erases++;
+    }
+    void lookup(size_t probes) { //probes is how many nodes (or groups) got looked at. Just the one add, the totals come from the histogram
+        if (probes < BINS - 1) {
+            probeCounts[probes]++;
+        } else { //long ones are rare, so keeping their exact total here costs nothing
+            probeCounts[BINS - 1]++;
+            longProbes += probes;
+        }
+    }
+
+    void resizeStarted() { //a resize, which can take more than one doubling
+        if (resizeStart == 0) {
+            resizes++;
+            resizeStart = now();
+            resizeDoublings = 0;
+        }
+    }
+    void doubled() {
+        doublings++;
+        resizeDoublings++;
+        if (resizeDoublings > maxDoublings) {
+            maxDoublings = resizeDoublings;
+        }
+    }
+    void halved() {
+        halvings++;
+    }
+    void reclaimed(size_t bytes) { //memory a shrink gave back
+        reclaimedBytes += bytes;
+    }
+    void sized(size_t slots) { //the table now has this many slots (or buckets), for knowing the most it ever had
+        if (slots > peakSlots) {
+            peakSlots = slots;
+        }
+    }
+    void resizeDone() { //for the chained table this can be many operations after it started, since the nodes move over bit by bit
+        if (resizeStart != 0) {
+            uint64_t took = now() - resizeStart;
+            resizeNanos += took;
+            if (took > maxResizeNanos) {
+                maxResizeNanos = took;
+            }
+            resizeStart = 0;
+        }
+    }
+#else
+    static const bool ENABLED = false;
+    bool sampleHash() {
+        return false;
+    }
+    void hashed(const Timer&, size_t = 1) {}
+    bool sampleInsert() {
+        return false;
+    }
+    void allocated(const Timer&) {}
+    void inserted(const Timer&) {}
+    void bulkInserted(size_t) {}
+    void erased() {}
+    void lookup(size_t) {}
+    void resizeStarted() {}
+    void doubled() {}
+    void halved() {}
+    void reclaimed(size_t) {}
+    void sized(size_t) {}
+    void resizeDone() {}
+#endif
+
+    //every stat and the table's shape as names and values, in a fixed order so the output can be read by a script
+    std::vector<std::pair<std::string, std::string> > fields(const TableShape& shape) const;
+private:
+    uint64_t probeCounts[BINS]; //how many lookups looked at each amount of nodes (or groups), the last one is that many or more
+    uint64_t longProbes; //how many nodes the lookups in the last bin looked at altogether
+    uint64_t inserts; //one by one
+    uint64_t bulkInserts; //through bulkInsert, which doesn't count anything else since it runs on several threads
+    uint64_t erases;
+    uint64_t resizes;
+    uint64_t doublings;
+    uint64_t resizeDoublings; //how many times the current resize has doubled
+    uint64_t maxDoublings; //the most any one resize doubled
+    uint64_t halvings;
+    uint64_t reclaimedBytes; //memory given back by shrinking
+    uint64_t peakSlots; //the most slots the table has ever had
+    uint64_t resizeStart; //when the current resize started, 0 if there isn't one
+    uint64_t resizeNanos;
+    uint64_t maxResizeNanos;
+    uint32_t hashTicks; //counts up to the next sample
+    uint32_t insertTicks;
+    uint64_t hashSamples;
+    uint64_t hashNanos;
+    uint64_t insertSamples;
+    uint64_t insertNanos; //not counting the hashing, which callers often do on their own before inserting
+    uint64_t allocNanos;
+};
+#endif
@@ -1,27 +1,41 @@
-//implementation file for students
-
-#include "Student.h"
-#include <string>
-using namespace std;
-
-Student::Student(string& firstname, string& lastname, int _id, float _gpa) { //constructs the student and sets all the data according to the given data
-    firstName = firstname;
-    lastName = lastname;
-    id = _id;
-    gpa = _gpa;
-}
-string& Student::getName(int which) { //returns the first name if 0 was passed, or last if any other int was given
-    if (!which) { //!0 == !false == true, so return the first name
-        return firstName;
-    } //otherwise return the last name
-    return lastName;
-}
-int Student::getID() { //return the student's id
-    return id;
-}
-float Student::getGPA() { //return the student's gpa
-    return gpa;
-}
-Student::~Student() { //default destructor
-    
-}
\ No newline at end of file
+//implementation file for students
+
+#include "Student.h"
+#include "NamePool.h"
+using namespace std;
+
+Student::Student(string_view firstname, string_view lastname, int _id, float _gpa) { //constructs the student and sets all the data according to the given data
+    firstName = NamePool::Intern(firstname);
+    lastName = NamePool::Intern(lastname);
+    id = _id;
+    gpa = _gpa;
+    row = -1; //not in a column until a table puts it in one
+}
+Student::Student(uint32_t firstname, uint32_t lastname, int _id, float _gpa) { //same, the names are already interned
+    firstName = firstname;
+    lastName = lastname;
+    id = _id;
+    gpa = _gpa;
+    row = -1;
+}
+string_view Student::getName(int which) { //returns the first name if 0 was passed, or last if any other int was given
+    if (!which) { //!0 == !false == true, so return the first name
+        return NamePool::Get(firstName);
+    } //otherwise return the last name
+    return NamePool::Get(lastName);
+}
+uint32_t Student::getNameID(int which) { //same as getName, but the ID instead of the text
+    return which ? lastName : firstName;
+}
+int Student::getID() { //return the student's id
+    return id;
+}
+float Student::getGPA() { //return the student's gpa
+    return gpa;
+}
+int Student::getRow() { //return where the student's gpa is in the gpa column
+    return row;
+}
+void Student::setRow(int _row) { //set where the student's gpa is in the gpa column
+    row = _row;
+}
@@ -1,22 +1,28 @@
-//header file for students
-
-#ifndef STUDENT
-#define STUDENT
-
-#include <string>
-
-class Student {
-public:
-    Student(std::string& firstname, std::string& lastname, int _id, float _gpa); //constructs the student with all the given data
-    ~Student(); //destructor (default, doesn't do anything)
-    
-    std::string& getName(int which); //returns first or last name based on if 0 or something else is passed for "which"
-    int getID(); //return the student's id
-    float getGPA(); //return the student's gpa
-private:
-    std::string firstName; //all the student's data
-    std::string lastName;
-    int id;
-    float gpa;
-};
-#endif
\ No newline at end of file
+//header file for students
+
+#ifndef STUDENT
+#define STUDENT
+
+#include <cstdint>
+#include <string_view>
+
+class Student {
+public:
+    Student(std::string_view firstname, std::string_view lastname, int _id, float _gpa); //constructs the student with all the given data, putting the names in the name pool
+    Student(uint32_t firstname, uint32_t lastname, int _id, float _gpa); //same but with names that are already in the pool
+    ~Student() = default; //doesn't do anything, so the tables can throw students away without calling it on every one
+
+    std::string_view getName(int which); //returns first or last name based on if 0 or something else is passed for "which"
+    uint32_t getNameID(int which); //same but the name's ID in the name pool, which is the same for everyone with the same name
+    int getID(); //return the student's id
+    float getGPA(); //return the student's gpa
+    int getRow(); //return where the student's gpa is in the gpa column, -1 if it isn't in one
+    void setRow(int _row); //set where the student's gpa is in the gpa column
+private:
+    uint32_t firstName; //all the student's data, the names are IDs in the name pool (see NamePool.h)
+    uint32_t lastName;
+    int id;
+    float gpa;
+    int row; //where the student's gpa is in the gpa column, the StudentTable keeps it up to date
+};
+#endif
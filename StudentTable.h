@@ -0,0 +1,473 @@
+//header file for the student table, which wraps either table engine and keeps a GpaColumn next to it with every student's GPA, so
+//AVERAGE doesn't have to walk the whole table anymore. It has the same interface as the engines, so the command loop, the journal and the
+//snapshots work on it without knowing it's there. Every student remembers their row in the column (Student::getRow), so erasing one only
+//has to move the last row into the hole and tell the student that got moved, and nothing ever walks the column to keep it in sync.
+//It can also keep secondary indexes (see Indexes.h) on last names and GPAs, so finding everyone with a last name or a range of GPAs doesn't
+//have to walk the whole table. They're off unless setIndexed turns them on, since every insert and erase has to update them too.
+//The same goes for the cuckoo filter (see CuckooFilter.h) that setFiltered turns on: finding or erasing an ID asks the filter first, and
+//if it says the ID isn't there, that's the answer, without hashing the ID or looking in the table at all.
+//freeze builds a FrozenTable (see FrozenTable.h) out of every student, and from then on every lookup goes to that instead of the engine, until
+//the next insert or erase throws it away.
+//openView opens a point-in-time ReadView (see ReadView.h) that read pages through while the table keeps changing, every insert, erase and
+//clear tells the open views about it first
+
+#ifndef STUDENT_TABLE
+#define STUDENT_TABLE
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Student.h"
+#include "GpaColumn.h"
+#include "Indexes.h"
+#include "CuckooFilter.h"
+#include "FrozenTable.h"
+#include "ReadView.h"
+#include "NamePool.h"
+#include "Stats.h"
+#include "Parallel.h"
+
+template <class Table>
+class StudentTable {
+public:
+    typedef typename Table::hash_type hash_type;
+    typedef typename Table::hasher_type hasher_type;
+    typedef typename Table::iterator iterator;
+
+    template <class... Args>
+    StudentTable(Args... args) : table(args...), indexed(false), filtered(false), filterNegatives(0), filterFalsePositives(0) {} //whatever the engine takes, like the chained table's starting length
+    StudentTable(const StudentTable&) = delete;
+    StudentTable& operator=(const StudentTable&) = delete;
+
+    hash_type hash(int id) const {
+        return table.hash(id);
+    }
+    void hash(const int* ids, size_t n, hash_type* out) const {
+        table.hash(ids, n, out);
+    }
+
+    bool insert(int id, const Student& student) {
+        return insert(id, student, table.hash(id));
+    }
+    bool insert(int id, const Student& student, hash_type hash) {
+        Student placed = student; //the copy that goes in already knows its row, so it doesn't have to be found again afterwards
+        placed.setRow(column.size());
+        if (!table.insert(id, placed, hash)) {
+            return false;
+        }
+        frozen.clear(); //out of date now
+        if (viewsOpen()) {
+            viewsAdded(id, hash);
+        }
+        column.add(id, placed.getGPA());
+        if (filtered) {
+            addToFilter(id);
+        }
+        if (indexed) {
+            names.add(placed.getNameID(1), id);
+            gpaIndex.add(placed.getGPA(), id);
+        }
+        return true;
+    }
+
+    Student* find(int id) {
+        if (frozen.built()) { //the frozen table already answers in a cache miss or two, so it doesn't need the filter
+            return frozen.find(id);
+        }
+        if (filtered && !filter.mayContain(id)) { //definitely not there, so it doesn't even get hashed
+            filterNegatives++;
+            return NULL;
+        }
+        return filtered ? checkedFind(id, table.hash(id)) : table.find(id);
+    }
+    Student* find(int id, hash_type hash) { //the caller already hashed it, but the filter still saves looking in the table
+        if (frozen.built()) {
+            return frozen.find(id);
+        }
+        if (filtered && !filter.mayContain(id)) {
+            filterNegatives++;
+            return NULL;
+        }
+        return filtered ? checkedFind(id, hash) : table.find(id, hash);
+    }
+    //finds n IDs at once with the engine's findMany, out[i] is the student with ids[i] or NULL. With the filter on, only the IDs it lets
+    //through go to the table, packed together so the batches stay full
+    void findMany(const int* ids, size_t n, Student** out) {
+        if (frozen.built()) {
+            frozen.findMany(ids, n, out);
+            return;
+        }
+        if (!filtered) {
+            table.findMany(ids, n, out);
+            return;
+        }
+        passed.clear();
+        passedAt.clear();
+        for (size_t i = 0; i < n; i++) {
+            out[i] = NULL;
+            if (filter.mayContain(ids[i])) {
+                passed.push_back(ids[i]);
+                passedAt.push_back(i);
+            } else {
+                filterNegatives++;
+            }
+        }
+        passedFound.resize(passed.size());
+        table.findMany(passed.data(), passed.size(), passedFound.data());
+        for (size_t i = 0; i < passed.size(); i++) {
+            out[passedAt[i]] = passedFound[i];
+            filterFalsePositives += passedFound[i] == NULL;
+        }
+    }
+
+    bool erase(int id) {
+        if (filtered && !filter.mayContain(id)) {
+            filterNegatives++;
+            return false;
+        }
+        return erase(id, table.hash(id));
+    }
+    bool erase(int id, hash_type hash) {
+        Student* student = find(id, hash);
+        if (student == NULL) {
+            return false;
+        }
+        if (frozen.built()) { //the student found was the frozen copy, but it's the one in the table that's getting erased
+            frozen.clear();
+            student = table.find(id, hash);
+        }
+        if (viewsOpen()) {
+            viewsErasing(id, *student, hash);
+        }
+        if (filtered) {
+            filter.remove(id);
+        }
+        if (indexed) { //before the erase, since that deletes the student
+            names.remove(student->getNameID(1), id);
+            gpaIndex.remove(student->getGPA(), id);
+        }
+        int row = student->getRow();
+        int moved = column.remove(row);
+        if (moved != id) { //the last row got moved into this one, so that student has to know where they are now
+            table.find(moved)->setRow(row);
+        }
+        return table.erase(id, hash);
+    }
+
+    //presizes the engine (which then never shrinks below that) and the column for the given amount of students
+    void reserve(size_t students) {
+        table.reserve(students);
+        column.reserve(students);
+    }
+
+    //the students are built by make on the engine's threads, and each one gets the next row of the column right there (an atomic counter, so
+    //the rows stay one after the other whichever thread gets which). The engines only call make for keys they actually insert, so whoever
+    //got each row is written down as they go, and the column, indexes, filter and views get fed from that afterwards on this thread, without
+    //looking any of the new students up again
+    template <class Make>
+    size_t bulkInsert(const int* ids, size_t n, Make make, unsigned threads = defaultThreads()) {
+        return bulkInsert(ids, (const hash_type*)NULL, n, make, threads);
+    }
+    template <class Make>
+    size_t bulkInsert(const int* ids, const hash_type* hashes, size_t n, Make make, unsigned threads = defaultThreads()) {
+        size_t firstRow = column.size();
+        std::atomic<size_t> nextRow(firstRow);
+        std::vector<Placed> placed(n); //placed[row - firstRow] is who got the row
+        size_t inserted = table.bulkInsert(ids, hashes, n, [&](size_t i) {
+            Student student = make(i);
+            size_t row = nextRow++;
+            student.setRow(row);
+            placed[row - firstRow] = Placed{i, student.getGPA(), student.getNameID(1)};
+            return student;
+        }, threads);
+        if (inserted > 0) {
+            frozen.clear();
+        }
+        column.reserve(firstRow + inserted);
+        bool refilter = filtered && filter.size() + inserted > filter.capacity(); //too many to fit, so the filter gets rebuilt bigger afterwards
+        bool viewing = inserted > 0 && viewsOpen();
+        std::vector<GpaIndex::Entry> entries;
+        for (size_t r = 0; r < inserted; r++) { //in row order, so column.add hands out the same rows the students already have
+            int id = ids[placed[r].key];
+            column.add(id, placed[r].gpa);
+            if (viewing) {
+                viewsAdded(id, hashes == NULL ? table.hash(id) : hashes[placed[r].key]);
+            }
+            //a cuckoo insert can still fail short of capacity, and rebuilding right then would put the rest of these IDs in a second time
+            //(the rebuild already gets them from the table), so it waits until after the loop instead
+            if (filtered && !refilter && !filter.insert(id)) {
+                refilter = true;
+            }
+            if (indexed) {
+                names.add(placed[r].lastName, id);
+                entries.push_back(GpaIndex::Entry{placed[r].gpa, id});
+            }
+        }
+        gpaIndex.addMany(entries);
+        if (refilter) {
+            rebuildFilter();
+        }
+        return inserted;
+    }
+
+    void clear() {
+        frozen.clear();
+        if (viewsOpen()) { //everyone the views haven't read yet gets copied, and then there's nothing left for them in the table
+            for (iterator it = table.begin(); it != table.end(); ++it) {
+                viewsErasing(it.key(), *it, it.hash());
+            }
+            for (std::shared_ptr<ReadView>& view : views) {
+                view->inTable = false;
+            }
+            viewsOpen();
+        }
+        table.clear();
+        column.clear();
+        names.clear();
+        gpaIndex.clear();
+        if (filtered) {
+            filter.reset(0);
+        }
+    }
+
+    //turns the indexes on (building them from every student already in the table) or off (throwing them away)
+    void setIndexed(bool on) {
+        names.clear();
+        gpaIndex.clear();
+        indexed = on;
+        std::vector<GpaIndex::Entry> entries;
+        for (iterator it = table.begin(); it != table.end() && on; ++it) {
+            names.add(it->getNameID(1), it.key());
+            entries.push_back(GpaIndex::Entry{it->getGPA(), it.key()});
+        }
+        gpaIndex.addMany(entries);
+    }
+    bool isIndexed() const {
+        return indexed;
+    }
+    //turns the filter on (building it from every ID already in the table) or off
+    void setFiltered(bool on) {
+        filtered = on;
+        if (on) {
+            rebuildFilter();
+        } else {
+            filter.reset(0);
+        }
+    }
+
+    //builds the frozen table out of every student, and lookups use it until the next change
+    void freeze() {
+        std::vector<Student> students;
+        students.reserve(table.size());
+        for (iterator it = table.begin(); it != table.end(); ++it) {
+            students.push_back(*it);
+        }
+        frozen.build(students);
+    }
+    const FrozenTable& frozenTable() const {
+        return frozen;
+    }
+
+    //opens a view of every student as they are right now, nothing gets copied until something changes where its scan hasn't been yet
+    std::shared_ptr<ReadView> openView() {
+        views.push_back(std::make_shared<ReadView>(table.size()));
+        table.setShrinking(false);
+        return views.back();
+    }
+    //reads about count more of the view's students, calling visit(id, student) for each, and returns how many it has left (0 once it's done).
+    //First the live table gets scanned, skipping the IDs the view doesn't have, and then come the copies of the ones that got erased
+    template <class Visit>
+    size_t read(ReadView& view, size_t count, Visit visit) {
+        size_t visited = 0;
+        if (view.inTable) {
+            view.at = table.scan(view.at, count, [&](int id, Student& student, hash_type) {
+                if (!view.hides(id)) {
+                    visit(id, student);
+                    visited++;
+                }
+            });
+            view.inTable = view.at != 0; //any erase from now on doesn't need a copy, so the view stops getting told about them
+        }
+        for (; !view.inTable && view.nextCopy < view.copied.size() && visited < count; view.nextCopy++, visited++) {
+            visit(view.copied[view.nextCopy].getID(), view.copied[view.nextCopy]);
+        }
+        view.read += visited;
+        return view.left();
+    }
+
+    //calls visit(student) for everyone with the given last name and returns how many there were. Without the index it has to walk every student
+    template <class Visit>
+    size_t withLastName(const std::string& name, Visit visit) {
+        size_t found = 0;
+        uint32_t nameID;
+        if (!NamePool::Find(name, nameID)) { //nobody has ever had the name
+            return 0;
+        }
+        if (indexed) {
+            const std::vector<int>* ids = names.find(nameID);
+            for (size_t i = 0; ids != NULL && i < ids->size(); i++, found++) {
+                visit(*table.find((*ids)[i]));
+            }
+            return found;
+        }
+        for (iterator it = table.begin(); it != table.end(); ++it) {
+            if (it->getNameID(1) == nameID) { //comparing IDs, since the same name always has the same one
+                visit(*it);
+                found++;
+            }
+        }
+        return found;
+    }
+    //same for everyone with a GPA from low to high (inclusive). With the index they come lowest GPA first, without it in table order
+    template <class Visit>
+    size_t withGpaBetween(float low, float high, Visit visit) {
+        if (indexed) {
+            return gpaIndex.between(low, high, [&](int id) {
+                visit(*table.find(id));
+            });
+        }
+        size_t found = 0;
+        for (iterator it = table.begin(); it != table.end(); ++it) {
+            if (it->getGPA() >= low && it->getGPA() <= high) {
+                visit(*it);
+                found++;
+            }
+        }
+        return found;
+    }
+    size_t size() const {
+        return table.size();
+    }
+    bool empty() const {
+        return table.empty();
+    }
+    iterator begin() {
+        return table.begin();
+    }
+    iterator end() {
+        return table.end();
+    }
+    //the engine's scan, calls visit(id, student, hash) a batch at a time, see HashTable::scan
+    template <class Visit>
+    size_t scan(size_t cursor, size_t limit, Visit visit) {
+        return table.scan(cursor, limit, visit);
+    }
+
+    const GpaColumn& gpas() const { //the running aggregates and the column itself, for AVERAGE
+        return column;
+    }
+    const TableStats& stats() const {
+        return table.stats();
+    }
+    TableShape shape() const { //the engine's shape, with the column, the indexes and the name pool counted in the bytes
+        TableShape result = table.shape();
+        result.bytes += column.bytes() + (indexed ? names.bytes() + gpaIndex.bytes() : 0) + NamePool::Bytes() + (filtered ? filter.bytes() : 0) + frozen.bytes();
+        size_t openViews = 0;
+        size_t viewBytes = 0;
+        for (const std::shared_ptr<ReadView>& view : views) { //the ones that got closed or read to the end are only dropped on the next change
+            if (view.use_count() > 1 && view->reading()) {
+                openViews++;
+                viewBytes += view->bytes();
+            }
+        }
+        result.bytes += viewBytes;
+        result.extra.push_back(std::make_pair("views", std::to_string(openViews)));
+        result.extra.push_back(std::make_pair("view_bytes", std::to_string(viewBytes)));
+        result.extra.push_back(std::make_pair("frozen", frozen.built() ? "yes" : "no"));
+        if (frozen.built()) {
+            result.extra.push_back(std::make_pair("frozen_bytes", std::to_string(frozen.bytes())));
+            result.extra.push_back(std::make_pair("frozen_bytes_per_record", std::to_string(frozen.size() ? (double)frozen.bytes() / frozen.size() : 0)));
+            result.extra.push_back(std::make_pair("frozen_build_ms", std::to_string(frozen.buildMillis())));
+        }
+        if (filtered) { //how well the filter is doing: of the lookups of IDs that weren't there, how many it let through to the table anyway
+            uint64_t absent = filterNegatives + filterFalsePositives;
+            result.extra.push_back(std::make_pair("filter_ids", std::to_string(filter.size())));
+            result.extra.push_back(std::make_pair("filter_capacity", std::to_string(filter.capacity())));
+            result.extra.push_back(std::make_pair("filter_bytes", std::to_string(filter.bytes())));
+            result.extra.push_back(std::make_pair("filter_negatives", std::to_string(filterNegatives)));
+            result.extra.push_back(std::make_pair("filter_false_positives", std::to_string(filterFalsePositives)));
+            result.extra.push_back(std::make_pair("filter_fp_rate", std::to_string(absent ? (double)filterFalsePositives / absent : 0)));
+        }
+        return result;
+    }
+private:
+    struct Placed { //a student bulkInsert put in, by their row
+        size_t key; //where their ID is in the IDs bulkInsert got
+        float gpa;
+        uint32_t lastName; //for the name index
+    };
+
+    //drops the views nobody else has anymore and the ones that are through the live table, and lets the table shrink again once none are
+    //left. Returns whether any are left, the writers only call the two below if there are
+    bool viewsOpen() {
+        if (views.empty()) {
+            return false;
+        }
+        for (size_t i = 0; i < views.size();) {
+            if (views[i].use_count() == 1 || !views[i]->reading()) { //the copies of the ones still being read get freed along with the view
+                views[i] = views.back();
+                views.pop_back();
+            } else {
+                i++;
+            }
+        }
+        table.setShrinking(views.empty());
+        return !views.empty();
+    }
+    void viewsAdded(int id, hash_type hash) { //only the views whose scans still have to get to the ID need to know
+        for (std::shared_ptr<ReadView>& view : views) {
+            if (!Table::scanned(view->cursor(), hash)) {
+                view->added(id);
+            }
+        }
+    }
+    void viewsErasing(int id, const Student& student, hash_type hash) {
+        for (std::shared_ptr<ReadView>& view : views) {
+            if (!Table::scanned(view->cursor(), hash)) {
+                view->erasing(id, student);
+            }
+        }
+    }
+    Student* checkedFind(int id, hash_type hash) { //a find the filter let through, counting it if it was for nothing
+        Student* student = table.find(id, hash);
+        filterFalsePositives += student == NULL;
+        return student;
+    }
+    void addToFilter(int id) { //the ID is already in the table, so if the filter is full, rebuilding it from the table puts it in too
+        if (filter.size() >= filter.capacity() || !filter.insert(id)) {
+            rebuildFilter();
+        }
+    }
+    void rebuildFilter() { //puts every ID in the table into a new filter with room for twice as many, bigger again in the unlikely case they don't fit
+        for (size_t capacity = table.size() * 2;; capacity *= 2) {
+            filter.reset(capacity);
+            bool fits = true;
+            for (iterator it = table.begin(); it != table.end() && fits; ++it) {
+                fits = filter.insert(it.key());
+            }
+            if (fits) {
+                return;
+            }
+        }
+    }
+
+    Table table;
+    GpaColumn column;
+    bool indexed; //whether the indexes are on
+    NameIndex names;
+    GpaIndex gpaIndex;
+    bool filtered; //whether the filter is on
+    CuckooFilter filter;
+    uint64_t filterNegatives; //lookups the filter answered on its own
+    uint64_t filterFalsePositives; //lookups it let through for IDs that weren't there
+    std::vector<int> passed; //findMany's IDs that got past the filter, kept around so every call doesn't allocate them again
+    std::vector<size_t> passedAt; //where each of them was in the IDs findMany got
+    std::vector<Student*> passedFound;
+    FrozenTable frozen; //empty unless freeze was called since the last change
+    std::vector<std::shared_ptr<ReadView> > views; //every open view whose scan is still in the live table
+};
+#endif
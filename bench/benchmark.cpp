@@ -0,0 +1,646 @@
+/* Benchmarks for the hash tables, separate from the database program so it doesn't get in the way of the command line.
+*  Build it with make benchmark (or from the repository root with: g++ -O2 -std=c++17 -pthread -o benchmark bench/benchmark.cpp SHA3.cpp Student.cpp Snapshot.cpp Journal.cpp Stats.cpp GpaColumn.cpp Indexes.cpp NamePool.cpp CuckooFilter.cpp FrozenTable.cpp ReadView.cpp)
+*
+*  Run it with the amount of keys to use (default 1000000). It runs these, in this order:
+*   1. the SHA-3 paths (the generic Hash, the fixed-size HashFixed, and the parallel HashBatch), making sure they all give the exact same
+*      hashes before timing them
+*   2. for each hasher, how long a hash takes on its own, how long inserting every key into the chained table takes, and the chain length
+*      distribution the table ends up with
+*   3. every single insert timed on its own, as a latency histogram, since the slowest inserts are the ones that trigger a resize
+*   4. bulk loading the same amount of students with bulkInsert on 1, 2, 4, ... threads up to one per core, to see how well the bulk path
+*      scales compared to inserting them one by one
+*   5. the throughput of the concurrent table against the chained table behind one big lock, on a read-heavy workload (95% finds) and a
+*      mixed one (50% finds, the rest inserts and erases), with 1, 2, 4, ... threads up to twice the amount of cores
+*   6. journaling inserts with each fsync policy, in a journal file made (and deleted) in the current directory
+*   7. averaging every GPA by walking the table against the StudentTable's running total, and averaging a range of GPAs by walking the
+*      table against scanning the GPA column with SIMD
+*   8. finding everyone with a last name and everyone in a narrow range of GPAs with and without the secondary indexes, and how much
+*      keeping the indexes up to date adds to inserting and erasing
+*   9. for every hasher, finding IDs that aren't there and IDs that are, with and without the cuckoo filter in front of the table, and
+*      how many of the absent IDs the filter let through anyway
+*  10. looking up every student of a table of at least 8 million of them in a random order, one at a time and with findMany in batches,
+*      on both engines
+*  11. the same lookups again before and after FREEZE, along with how long freezing took and how much memory the frozen table takes
+*  12. erasing 99% of the students and walking every slot like PRINT does, with the table shrinking as they get erased against one that
+*      was reserved for all of them so it can't, along with how much memory each one ends up with
+*  13. adding and erasing students with no read view open, with one that was just opened, and with one that's been read halfway, along
+*      with how much each view had to copy
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <random>
+#include <thread>
+#include "../Student.h"
+#include "../Hashers.h"
+#include "../HashTable.h"
+#include "../FlatTable.h"
+#include "../ConcurrentTable.h"
+#include "../Journal.h"
+#include "../StudentTable.h"
+using namespace std;
+
+//the current time in seconds, for timing things
+double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//checks that every SHA-3 path gives the same hashes for the given amount of IDs (some negative too), then times each one. Returns false if any hash differed
+bool benchSHA3(int amount) {
+    vector<int> ids;
+    for (int id = 1; id <= amount; id++) {
+        ids.push_back(id % 2 ? id : -id * 7919); //every other one is negative and spread out, so the top bytes get tested too
+    }
+    vector<SHA3::digest> batch(ids.size());
+    SHA3::HashBatch(ids.data(), ids.size(), batch.data());
+    for (size_t i = 0; i < ids.size(); i++) {
+        string generic = SHA3::Hash(ids[i]);
+        SHA3::digest fixed = SHA3::HashFixed(ids[i]);
+        if (memcmp(generic.data(), fixed.data(), 32) || memcmp(generic.data(), batch[i].data(), 32)) {
+            cout << "SHA-3 paths disagree on ID " << ids[i] << "!\n";
+            return false;
+        }
+    }
+
+    uint8_t sink = 0;
+    double start = now();
+    for (int id : ids) {
+        sink ^= SHA3::Hash(id)[0];
+    }
+    double genericTime = now() - start;
+    start = now();
+    for (int id : ids) {
+        sink ^= SHA3::HashFixed(id)[0];
+    }
+    double fixedTime = now() - start;
+    start = now();
+    SHA3::HashBatch(ids.data(), ids.size(), batch.data());
+    double batchTime = now() - start;
+
+    cout << "SHA-3 paths agree on all " << ids.size() << " IDs" << (sink == 42 ? " " : "") << "\n" << fixed << setprecision(1)
+         << "  Hash       " << setw(8) << genericTime * 1e9 / amount << " ns/hash\n"
+         << "  HashFixed  " << setw(8) << fixedTime * 1e9 / amount << " ns/hash\n"
+         << "  HashBatch  " << setw(8) << batchTime * 1e9 / amount << " ns/hash\n";
+    return true;
+}
+
+//times hashing and inserting the given amount of sequential IDs with the given hasher, and prints how long the chains got
+template <class Hasher>
+void benchHasher(const string& name, int amount) {
+    Hasher hasher;
+    size_t sink = 0; //the hashes get folded into here so the compiler can't skip computing them
+    double start = now();
+    for (int id = 1; id <= amount; id++) {
+        sink ^= hasher(id);
+    }
+    double hashTime = now() - start;
+
+    string first = "Harry";
+    string last = "Table";
+    HashTable<int, Student, Hasher> table(128);
+    start = now();
+    for (int id = 1; id <= amount; id++) {
+        table.insert(id, Student(first, last, id, 0));
+    }
+    double insertTime = now() - start;
+
+    table.finishResize(); //so every node is in the table we're measuring
+    size_t lengths[5] = {0}; //how many chains have 0, 1, 2, 3, and 4 or more nodes
+    for (size_t i = 0; i < table.bucketCount(); i++) {
+        size_t length = table.bucketSize(i);
+        lengths[length < 4 ? length : 4]++;
+    }
+
+    cout << left << setw(8) << name << right << fixed << setprecision(1)
+         << setw(10) << hashTime * 1e9 / amount << " ns/hash"
+         << setw(10) << insertTime * 1e9 / amount << " ns/insert"
+         << setw(12) << table.bucketCount() << " buckets  chains:";
+    for (int i = 0; i < 5; i++) {
+        cout << " " << i << (i == 4 ? "+" : "") << "=" << setprecision(1) << lengths[i] * 100.0 / table.bucketCount() << "%";
+    }
+    cout << (sink == 42 ? " " : "") << "\n"; //uses the sink so it isn't optimized away
+}
+
+//times each insert of the given amount of sequential IDs into the chained table on its own and prints the latency percentiles and a histogram
+//with power of two buckets. The mix hasher is used so the times are the table's and not SHA-3's
+void benchLatency(int amount) {
+    string first = "Harry";
+    string last = "Table";
+    HashTable<int, Student, MixHasher> table(128);
+    vector<double> latencies(amount);
+    for (int id = 1; id <= amount; id++) {
+        double start = now();
+        table.insert(id, Student(first, last, id, 0));
+        latencies[id - 1] = (now() - start) * 1e9;
+    }
+    vector<size_t> histogram(40, 0); //bucket b counts inserts that took between 2^b and 2^(b+1) ns
+    for (double latency : latencies) {
+        int b = 0;
+        while (b < 39 && latency >= (double)(2ULL << b)) {
+            b++;
+        }
+        histogram[b]++;
+    }
+    sort(latencies.begin(), latencies.end());
+    cout << "Insert latency over " << amount << " inserts:\n" << fixed << setprecision(0)
+         << "  p50 " << latencies[amount / 2] << " ns  p99 " << latencies[(size_t)(amount * 0.99)] << " ns  p99.9 "
+         << latencies[(size_t)(amount * 0.999)] << " ns  max " << latencies.back() << " ns\n";
+    for (int b = 0; b < 40; b++) {
+        if (histogram[b]) {
+            cout << "  " << setw(12) << (1ULL << b) << " ns+ " << setw(10) << histogram[b] << "\n";
+        }
+    }
+}
+
+//times bulk loading the given amount of students into an empty chained table with different amounts of threads, against plain inserts
+void benchBulk(int amount) {
+    string first = "Harry";
+    string last = "Table";
+    vector<int> ids(amount);
+    for (int id = 1; id <= amount; id++) {
+        ids[id - 1] = id;
+    }
+    double start = now();
+    {
+        HashTable<int, Student, MixHasher> table(128);
+        for (int id : ids) {
+            table.insert(id, Student(first, last, id, 0));
+        }
+        table.finishResize();
+    }
+    double serialTime = now() - start;
+    cout << "Loading " << amount << " students:\n" << fixed << setprecision(1)
+         << "  insert one by one  " << setw(8) << serialTime * 1e9 / amount << " ns/student\n";
+    unsigned cores = defaultThreads();
+    for (unsigned threads = 1;; threads = threads * 2 < cores ? threads * 2 : cores) {
+        start = now();
+        {
+            HashTable<int, Student, MixHasher> table(128);
+            table.bulkInsert(ids.data(), ids.size(), [&](size_t i) {
+                return Student(first, last, ids[i], 0);
+            }, threads);
+        }
+        double bulkTime = now() - start;
+        cout << "  bulkInsert " << setw(3) << threads << " thr " << setw(8) << bulkTime * 1e9 / amount << " ns/student  "
+             << setw(5) << serialTime / bulkTime << "x\n";
+        if (threads == cores) {
+            break;
+        }
+    }
+}
+
+//the chained table behind one lock, which is what you'd have to do to share it between threads without the concurrent table
+struct LockedTable {
+    bool insert(int id, const Student& student) {
+        lock_guard<mutex> guard(lock);
+        return table.insert(id, student);
+    }
+    bool erase(int id) {
+        lock_guard<mutex> guard(lock);
+        return table.erase(id);
+    }
+    bool find(int id, Student& out) {
+        lock_guard<mutex> guard(lock);
+        Student* student = table.find(id);
+        if (student != NULL) {
+            out = *student;
+        }
+        return student != NULL;
+    }
+    mutex lock;
+    HashTable<int, Student, MixHasher> table;
+};
+
+//runs the given amount of operations split over the given amount of threads on the table, where readPercent of them are finds and the rest are
+//half inserts and half erases, all on random IDs up to twice the amount the table was filled with. Returns millions of operations per second
+template <class Table>
+double runWorkload(Table& table, int amount, size_t operations, unsigned threads, int readPercent) {
+    string first = "Harry";
+    string last = "Table";
+    atomic<size_t> found(0); //counts the successful finds, atomic so the finds can't be optimized away
+    vector<thread> workers;
+    double start = now();
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            minstd_rand rng(t + 1);
+            Student out(first, last, 0, 0);
+            size_t hits = 0;
+            for (size_t i = 0; i < operations / threads; i++) {
+                int id = rng() % (2 * amount) + 1;
+                int roll = rng() % 100;
+                if (roll < readPercent) {
+                    hits += table.find(id, out);
+                } else if (roll % 2) {
+                    table.insert(id, Student(first, last, id, 0));
+                } else {
+                    table.erase(id);
+                }
+            }
+            found += hits;
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double time = now() - start;
+    return operations / time / 1e6;
+}
+
+//fills a concurrent table and a locked chained table with the given amount of students and compares their throughput on a read-heavy and a
+//mixed workload with more and more threads
+void benchConcurrent(int amount) {
+    string first = "Harry";
+    string last = "Table";
+    ConcurrentTable<int, Student, MixHasher> concurrent;
+    LockedTable locked;
+    for (int id = 1; id <= amount; id++) {
+        concurrent.insert(id, Student(first, last, id, 0));
+        locked.insert(id, Student(first, last, id, 0));
+    }
+    size_t operations = 2 * (size_t)amount;
+    unsigned maxThreads = 2 * defaultThreads(); //past the amount of cores too, since threads getting descheduled while holding a lock is where locking hurts most
+    cout << "Concurrent throughput, " << operations << " operations on " << amount << " students (Mops/s):\n"
+         << "  threads   concurrent 95% read   locked 95% read   concurrent 50% read   locked 50% read\n" << fixed << setprecision(2);
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        cout << "  " << setw(7) << threads
+             << setw(22) << runWorkload(concurrent, amount, operations, threads, 95)
+             << setw(18) << runWorkload(locked, amount, operations, threads, 95)
+             << setw(22) << runWorkload(concurrent, amount, operations, threads, 50)
+             << setw(18) << runWorkload(locked, amount, operations, threads, 50) << "\n";
+    }
+}
+
+//times inserting the given amount of students into a chained table with a journal, once per fsync policy, including the final fsync.
+//Fsyncing every insert is so slow that ALWAYS only does a few thousand
+void benchJournal(int amount) {
+    string first = "Harry";
+    string last = "Table";
+    struct Policy {
+        const char* name;
+        Journal::SyncPolicy policy;
+        unsigned groupMillis;
+        int amount;
+    };
+    Policy policies[] = {
+        {"always", Journal::SYNC_ALWAYS, 0, min(amount, 2000)},
+        {"group 1ms", Journal::SYNC_GROUP, 1, amount},
+        {"group 10ms", Journal::SYNC_GROUP, 10, amount},
+        {"group 100ms", Journal::SYNC_GROUP, 100, amount},
+        {"never", Journal::SYNC_NEVER, 0, amount},
+    };
+    const string path = "benchmark.journal";
+    cout << "Journaled inserts:\n" << fixed << setprecision(0);
+    for (Policy& policy : policies) {
+        remove(path.c_str());
+        double start = now();
+        {
+            Journal journal(path, policy.policy, policy.groupMillis);
+            HashTable<int, Student, MixHasher> table(128);
+            int nextID = 1;
+            size_t replayed;
+            string error;
+            if (!journal.recover(table, nextID, replayed, error)) {
+                cout << "  couldn't open the journal, " << error << "\n";
+                return;
+            }
+            for (int id = 1; id <= policy.amount; id++) {
+                Student student(first, last, id, 0);
+                table.insert(id, student);
+                journal.add(student);
+            }
+        } //the journal writes and fsyncs the rest when it goes out of scope
+        double time = now() - start;
+        cout << "  " << left << setw(12) << policy.name << right << setw(12) << policy.amount / time << " inserts/s  ("
+             << policy.amount << " inserts)\n";
+    }
+    remove(path.c_str());
+}
+
+//times AVERAGE every way it can be done: walking the table like it used to, the running total, and for a range of GPAs walking the table
+//against the SIMD scan of the column. Each one runs a few times and the fastest counts, so a hiccup in the middle doesn't get measured
+void benchAggregates(int amount) {
+    string first = "Harry";
+    string last = "Table";
+    StudentTable<HashTable<int, Student, MixHasher> > table(128);
+    for (int id = 1; id <= amount; id++) {
+        table.insert(id, Student(first, last, id, (id * 7919 % 450) / 100.0)); //the same kind of GPAs GENERATE makes
+    }
+    const int RUNS = 5;
+    double sink = 0; //everything gets added in here so the compiler can't skip any of it
+    double best[4] = {1e9, 1e9, 1e9, 1e9};
+    for (int run = 0; run < RUNS; run++) {
+        double start = now();
+        double sum = 0;
+        for (Student& student : table) {
+            sum += student.getGPA();
+        }
+        sink += sum / table.size();
+        best[0] = min(best[0], now() - start);
+
+        start = now();
+        sink += table.gpas().average();
+        best[1] = min(best[1], now() - start);
+
+        start = now();
+        sum = 0;
+        size_t matched = 0;
+        for (Student& student : table) {
+            if (student.getGPA() >= 1.5f && student.getGPA() <= 3.0f) {
+                sum += student.getGPA();
+                matched++;
+            }
+        }
+        sink += sum / matched;
+        best[2] = min(best[2], now() - start);
+
+        start = now();
+        sink += table.gpas().sumBetween(1.5f, 3.0f, matched) / matched;
+        best[3] = min(best[3], now() - start);
+    }
+    const char* names[] = {"table walk", "running total", "range, table walk", "range, column scan"};
+    cout << "Averaging " << amount << " GPAs (fastest of " << RUNS << "):\n" << fixed << setprecision(3);
+    for (int i = 0; i < 4; i++) {
+        cout << "  " << left << setw(20) << names[i] << right << setw(12) << best[i] * 1e3 << " ms\n";
+    }
+    if (sink < 0) { //never, GPAs aren't negative
+        cout << sink << "\n";
+    }
+}
+
+//times the LASTNAME and RANGE queries with and without the indexes, and what the indexes cost every insert and erase. The students get one
+//of a thousand last names, so a last name matches about a thousandth of them, and the range is a hundredth of a GPA wide
+void benchIndexes(int amount) {
+    string first = "Harry";
+    vector<string> lasts;
+    for (int i = 0; i < 1000; i++) {
+        lasts.push_back("Table" + to_string(i));
+    }
+    cout << "Secondary index queries on " << amount << " students:\n" << fixed << setprecision(3);
+    for (int indexed = 0; indexed < 2; indexed++) {
+        StudentTable<HashTable<int, Student, MixHasher> > table(128);
+        table.setIndexed(indexed);
+        double start = now();
+        for (int id = 1; id <= amount; id++) {
+            table.insert(id, Student(first, lasts[id * 7919u % lasts.size()], id, (id * 7919 % 450) / 100.0));
+        }
+        double insertTime = now() - start;
+        size_t found = 0;
+        start = now();
+        found += table.withLastName("Table42", [](Student&) {});
+        double nameTime = now() - start;
+        start = now();
+        found += table.withGpaBetween(3.99f, 4.0f, [](Student&) {});
+        double rangeTime = now() - start;
+        start = now();
+        for (int id = 1; id <= amount; id++) {
+            table.erase(id);
+        }
+        double eraseTime = now() - start;
+        cout << "  " << (indexed ? "indexed" : "no index") << ":  lastname " << setw(9) << nameTime * 1e3 << " ms  range " << setw(9)
+             << rangeTime * 1e3 << " ms  (" << found << " found)  insert " << setprecision(1) << setw(7) << insertTime * 1e9 / amount
+             << " ns  erase " << setw(7) << eraseTime * 1e9 / amount << " ns\n" << setprecision(3);
+    }
+}
+
+//times lookups of absent and present IDs with and without the cuckoo filter, on a table of the given amount of students. The absent IDs are
+//all above the present ones, like the IDs GENERATE checks, so the filter's false positive rate gets measured on them too
+template <class Hasher>
+void benchFilter(const string& name, int amount) {
+    string first = "Harry";
+    string last = "Table";
+    for (int filtered = 0; filtered < 2; filtered++) {
+        StudentTable<HashTable<int, Student, Hasher> > table(128);
+        table.setFiltered(filtered);
+        double start = now();
+        for (int id = 1; id <= amount; id++) {
+            table.insert(id, Student(first, last, id, 0));
+        }
+        double insertTime = now() - start;
+        size_t found = 0;
+        start = now();
+        for (int id = amount + 1; id <= 2 * amount; id++) {
+            found += table.find(id) != NULL;
+        }
+        double missTime = now() - start;
+        start = now();
+        for (int id = 1; id <= amount; id++) {
+            found += table.find(id) != NULL;
+        }
+        double hitTime = now() - start;
+        cout << "  " << left << setw(8) << name << setw(10) << (filtered ? "filter" : "no filter") << right << fixed << setprecision(1)
+             << "  miss " << setw(7) << missTime * 1e9 / amount << " ns  hit " << setw(7) << hitTime * 1e9 / amount << " ns  insert "
+             << setw(7) << insertTime * 1e9 / amount << " ns";
+        if (filtered) {
+            for (const pair<string, string>& field : table.stats().fields(table.shape())) {
+                if (field.first == "filter_fp_rate" || field.first == "filter_bytes") {
+                    cout << "  " << field.first << "=" << field.second;
+                }
+            }
+        }
+        cout << (found == (size_t)amount ? "" : "  (lost keys!)") << "\n";
+    }
+}
+
+//times looking up every ID of a table of the given amount of students in a random order, one find at a time against findMany in batches.
+//The order is shuffled so every lookup is a cache miss (in order, the nodes would be next to each other in the pool and get prefetched anyway)
+template <class Table>
+void benchFindMany(const string& name, int amount) {
+    string first = "Harry";
+    string last = "Table";
+    Table table;
+    vector<int> ids(amount);
+    for (int id = 1; id <= amount; id++) {
+        table.insert(id, Student(first, last, id, 0));
+        ids[id - 1] = id;
+    }
+    shuffle(ids.begin(), ids.end(), mt19937(5));
+    size_t found = 0;
+    for (int id : ids) { //not timed, it's just so the chained table is done with any resize it's in the middle of before timing starts
+        found += table.find(id) != NULL;
+    }
+    double start = now();
+    for (int id : ids) {
+        found += table.find(id) != NULL;
+    }
+    double oneTime = now() - start;
+    cout << "  " << left << setw(8) << name << right << fixed << setprecision(1) << "  one at a time " << setw(6) << oneTime * 1e9 / amount << " ns";
+    vector<Student*> students(1024);
+    for (size_t batch : {16, 1024}) {
+        start = now();
+        for (size_t i = 0; i < ids.size(); i += batch) {
+            size_t n = ids.size() - i < batch ? ids.size() - i : batch;
+            table.findMany(&ids[i], n, students.data());
+            for (size_t j = 0; j < n; j++) {
+                found += students[j] != NULL;
+            }
+        }
+        double manyTime = now() - start;
+        cout << "  findMany(" << batch << ") " << setw(6) << manyTime * 1e9 / amount << " ns (" << setprecision(2) << oneTime / manyTime
+             << "x)" << setprecision(1);
+    }
+    cout << (found == 4 * (size_t)amount ? "" : "  (lost keys!)") << "\n";
+}
+
+//inserts the given amount of students, erases all but 1% of them, and times a full walk over what's left (through scan, like PRINT), once
+//with the table shrinking as they get erased and once with it reserved for all of them, which is how big the table always stayed before
+template <class Table>
+void benchShrink(const string& name, int amount) {
+    string first = "Harry";
+    string last = "Table";
+    for (int reserved = 0; reserved < 2; reserved++) {
+        Table table;
+        if (reserved) {
+            table.reserve(amount);
+        }
+        for (int id = 1; id <= amount; id++) {
+            table.insert(id, Student(first, last, id, 0));
+        }
+        size_t fullBytes = table.bytes();
+        for (int id = 1; id <= amount - amount / 100; id++) {
+            table.erase(id);
+        }
+        size_t walked = 0;
+        double start = now();
+        size_t cursor = 0;
+        do {
+            cursor = table.scan(cursor, 1024, [&](int, Student&, uint64_t) {
+                walked++;
+            });
+        } while (cursor != 0);
+        double walkTime = now() - start;
+        cout << "  " << left << setw(8) << name << setw(10) << (reserved ? "reserved" : "shrinking") << right << fixed << setprecision(3)
+             << "  walk " << setw(8) << walkTime * 1e3 << " ms  slots " << setw(9) << table.shape().slots << "  bytes " << setw(10)
+             << table.bytes() << " (was " << fullBytes << ")" << (walked == (size_t)(amount / 100) ? "" : "  (lost keys!)") << "\n";
+    }
+}
+
+//times looking up every student of a StudentTable in a random order, one at a time and with findMany, before and after freezing it, and
+//how long freezing took and how much memory the frozen table takes per student
+template <class Table>
+void benchFrozen(const string& name, int amount) {
+    StudentTable<Table> table;
+    vector<int> ids(amount);
+    for (int id = 1; id <= amount; id++) {
+        table.insert(id, Student("Harry", "Table", id, 0));
+        ids[id - 1] = id;
+    }
+    shuffle(ids.begin(), ids.end(), mt19937(5));
+    vector<Student*> students(1024);
+    size_t found = 0;
+    for (int id : ids) { //not timed, finishes any resize that's going on, like benchFindMany
+        found += table.find(id) != NULL;
+    }
+    for (int frozen = 0; frozen < 2; frozen++) {
+        if (frozen) {
+            table.freeze();
+        }
+        double start = now();
+        for (int id : ids) {
+            found += table.find(id) != NULL;
+        }
+        double oneTime = now() - start;
+        start = now();
+        for (size_t i = 0; i < ids.size(); i += 1024) {
+            size_t n = ids.size() - i < 1024 ? ids.size() - i : 1024;
+            table.findMany(&ids[i], n, students.data());
+            for (size_t j = 0; j < n; j++) {
+                found += students[j] != NULL;
+            }
+        }
+        double manyTime = now() - start;
+        cout << "  " << left << setw(8) << name << setw(8) << (frozen ? "frozen" : "live") << right << fixed << setprecision(1) << "  find "
+             << setw(6) << oneTime * 1e9 / amount << " ns  findMany " << setw(6) << manyTime * 1e9 / amount << " ns";
+        if (frozen) {
+            const FrozenTable& frozenTable = table.frozenTable();
+            cout << "  built in " << frozenTable.buildMillis() << " ms, " << setprecision(2) << (double)frozenTable.bytes() / frozenTable.size()
+                 << " bytes per student";
+        }
+        cout << "\n";
+    }
+    if (found != 5 * (size_t)amount) {
+        cout << "  (lost keys!)\n";
+    }
+}
+
+//times writing to a StudentTable of the given amount of students (adding that many new ones and erasing every one that was there) with no
+//view open, with a view that was just opened so every write lands where its scan still has to go, and with a view that's been read halfway,
+//then reads the views to the end to make sure they still have exactly the students from when they were opened
+template <class Table>
+void benchViews(const string& name, int amount) {
+    for (int mode = 0; mode < 3; mode++) {
+        StudentTable<Table> table;
+        for (int id = 1; id <= amount; id++) {
+            table.insert(id, Student("Harry", "Table", id, 0));
+        }
+        shared_ptr<ReadView> view;
+        size_t read = 0;
+        if (mode > 0) {
+            view = table.openView();
+            while (mode == 2 && read < (size_t)amount / 2) {
+                table.read(*view, 1024, [&](int, Student&) {
+                    read++;
+                });
+            }
+        }
+        double start = now();
+        for (int id = 1; id <= amount; id++) {
+            table.insert(amount + id, Student("Harry", "Table", amount + id, 0));
+            table.erase(id);
+        }
+        double writeTime = now() - start;
+        cout << "  " << left << setw(8) << name << setw(14) << (mode == 0 ? "no view" : mode == 1 ? "unread view" : "half read") << right << fixed
+             << setprecision(1) << "  write " << setw(6) << writeTime * 1e9 / (2 * amount) << " ns";
+        if (mode > 0) {
+            size_t copies = view->copies();
+            size_t bytes = view->bytes();
+            while (table.read(*view, 1024, [&](int id, Student&) {
+                read += id <= amount;
+            }) > 0) {}
+            cout << "  copied " << setw(9) << copies << " students, " << setw(10) << bytes << " bytes" << (read == (size_t)amount ? "" : "  (wrong students!)");
+        }
+        cout << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int amount = argc > 1 ? atoi(argv[1]) : 1000000; //how many keys to use
+    if (!benchSHA3(amount)) {
+        return 1;
+    }
+    cout << "Hashing and inserting " << amount << " sequential IDs:\n";
+    benchHasher<SHA3Hasher>("sha3", amount);
+    benchHasher<WyHasher>("wyhash", amount);
+    benchHasher<MixHasher>("mix", amount);
+    benchLatency(amount);
+    benchBulk(amount);
+    benchConcurrent(amount);
+    benchJournal(amount);
+    benchAggregates(amount);
+    benchIndexes(amount);
+    cout << "Lookups with and without the cuckoo filter, " << amount << " students and " << amount << " absent IDs:\n";
+    benchFilter<SHA3Hasher>("sha3", amount);
+    benchFilter<WyHasher>("wyhash", amount);
+    benchFilter<MixHasher>("mix", amount);
+    int big = amount > 8000000 ? amount : 8000000; //at least 8 million students, so the table is way bigger than any cache
+    cout << "Random lookups of all " << big << " students, one at a time and batched:\n";
+    benchFindMany<HashTable<int, Student, MixHasher> >("chained", big);
+    benchFindMany<FlatTable<int, Student, MixHasher> >("flat", big);
+    cout << "Random lookups of all " << big << " students before and after FREEZE:\n";
+    benchFrozen<HashTable<int, Student, MixHasher> >("chained", big);
+    benchFrozen<FlatTable<int, Student, MixHasher> >("flat", big);
+    cout << "Walking the table after erasing 99% of " << amount << " students, shrinking against reserved so it can't:\n";
+    benchShrink<HashTable<int, Student, MixHasher> >("chained", amount);
+    benchShrink<FlatTable<int, Student, MixHasher> >("flat", amount);
+    cout << "Adding and erasing " << amount << " students each with and without a read view open:\n";
+    benchViews<HashTable<int, Student, MixHasher> >("chained", amount);
+    benchViews<FlatTable<int, Student, MixHasher> >("flat", amount);
+}
@@ -0,0 +1,264 @@
+/* Load generator for the server mode (--serve=<socket>), a separate program so it can be run against a server in another terminal.
+*  Build it with make loadgen (or from the repository root with: g++ -O2 -std=c++17 -o loadgen bench/loadgen.cpp)
+*
+*  Run it with the socket path and any of --connections=<n> (default 64), --pipeline=<n> (how many commands each connection sends at once
+*  before waiting for the answers, default 16), --seconds=<n> (default 5), --keys=<n> (GETs, ADDs and DELETEs use random IDs from 1 to this,
+*  default 100000), --reads=<percent> (how many of the commands are GETs, the rest are half ADDs and half DELETEs, default 90),
+*  --averages=<percent> (how many are AVERAGEs, default 0) and --fill (GENERATEs the keys first, on a fresh server that makes IDs 1 to keys).
+*  Every connection is its own client, all driven from one thread with epoll so thousands of them don't need thousands of threads. At the
+*  end it prints how many commands per second got answered and the latency percentiles, where a command's latency is from when its batch
+*  got sent until its answer came back.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <random>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+//the current time in seconds, for timing things
+double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Client {
+    int fd;
+    string unsent; //the part of the batch the socket didn't take yet
+    string partial; //the start of an answer that hasn't fully arrived
+    int waiting; //how many answers of the current batch haven't come back
+    double sentAt; //when the current batch got sent
+    bool writable; //whether epoll is also watching for room to send the rest of the batch
+    minstd_rand random;
+};
+
+//connects to the server's socket, returns -1 (and says why) if it can't
+int connectTo(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        cerr << "Couldn't connect to " << path << ", " << strerror(errno) << ".\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+//sends as much of the client's unsent commands as the socket takes, returns false if the server is gone
+bool sendSome(Client& client) {
+    while (!client.unsent.empty()) {
+        ssize_t put = send(client.fd, client.unsent.data(), client.unsent.size(), MSG_NOSIGNAL);
+        if (put < 0) {
+            return errno == EAGAIN || errno == EINTR;
+        }
+        client.unsent.erase(0, put);
+    }
+    return true;
+}
+
+//makes a batch of pipeline random commands for the client and starts sending it
+bool sendBatch(Client& client, int pipeline, int keys, int reads, int averages) {
+    char command[64];
+    for (int i = 0; i < pipeline; i++) {
+        int roll = client.random() % 100;
+        int id = client.random() % keys + 1;
+        if (roll < averages) {
+            client.unsent += "AVERAGE\n";
+            continue;
+        } else if (roll < averages + reads) {
+            snprintf(command, sizeof(command), "GET %d\n", id);
+        } else if (roll % 2 == 0) {
+            snprintf(command, sizeof(command), "ADD Load Generator %d 3.00\n", id);
+        } else {
+            snprintf(command, sizeof(command), "DELETE %d\n", id);
+        }
+        client.unsent += command;
+    }
+    client.waiting = pipeline;
+    client.sentAt = now();
+    return sendSome(client);
+}
+
+//makes epoll also watch for room to send if the client has part of its batch left, only bothering epoll when that changes (hardly ever)
+void watch(int epoll, Client& client, int index) {
+    if (client.writable == client.unsent.empty()) {
+        client.writable = !client.writable;
+        epoll_event event;
+        event.events = EPOLLIN | (client.writable ? EPOLLOUT : 0);
+        event.data.u32 = index;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, client.fd, &event);
+    }
+}
+
+//the value at the given fraction of the way through the sorted latencies
+double percentile(const vector<float>& sorted, double fraction) {
+    return sorted.empty() ? 0 : sorted[min(sorted.size() - 1, (size_t)(fraction * sorted.size()))];
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argv[1][0] == '-') {
+        cerr << "Usage: loadgen <socket> [--connections=<n>] [--pipeline=<n>] [--seconds=<n>] [--keys=<n>] [--reads=<percent>] [--averages=<percent>] [--fill]\n";
+        return 1;
+    }
+    string path = argv[1];
+    int connections = 64;
+    int pipeline = 16;
+    double seconds = 5;
+    int keys = 100000;
+    int reads = 90;
+    int averages = 0;
+    bool fill = false;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        size_t equals = arg.find('=');
+        string name = arg.substr(0, equals);
+        int value = equals == string::npos ? 0 : atoi(arg.c_str() + equals + 1);
+        if (name == "--connections" && value > 0) {
+            connections = value;
+        } else if (name == "--pipeline" && value > 0) {
+            pipeline = value;
+        } else if (name == "--seconds" && value > 0) {
+            seconds = value;
+        } else if (name == "--keys" && value > 0) {
+            keys = value;
+        } else if (name == "--reads" && value >= 0 && value <= 100) {
+            reads = value;
+        } else if (name == "--averages" && value >= 0 && value <= 100) {
+            averages = value;
+        } else if (arg == "--fill") {
+            fill = true;
+        } else {
+            cerr << "Unknown argument \"" << arg << "\".\n";
+            return 1;
+        }
+    }
+    reads = min(reads, 100 - averages);
+
+    if (fill) { //one plain blocking round trip before the clients start
+        int fd = connectTo(path);
+        if (fd < 0) {
+            return 1;
+        }
+        string command = "GENERATE " + to_string(keys) + "\n";
+        string answer;
+        char letter;
+        if (send(fd, command.data(), command.size(), MSG_NOSIGNAL) != (ssize_t)command.size()) {
+            cerr << "Lost the server while filling it.\n";
+            return 1;
+        }
+        while (::read(fd, &letter, 1) == 1 && letter != '\n') {
+            answer += letter;
+        }
+        close(fd);
+        cout << "GENERATE " << keys << ": " << answer << "\n";
+    }
+
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    vector<Client> clients(connections);
+    for (int i = 0; i < connections; i++) {
+        Client& client = clients[i];
+        client.fd = connectTo(path);
+        if (client.fd < 0) {
+            return 1;
+        }
+        fcntl(client.fd, F_SETFL, O_NONBLOCK);
+        client.random.seed(i + 1);
+        client.writable = false;
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, client.fd, &event);
+    }
+
+    vector<float> latencies; //in microseconds
+    latencies.reserve(1 << 22);
+    long long errors = 0; //answers starting with ERR, like GETs of IDs that aren't there or ADDs of ones that are
+    double start = now();
+    double end = start + seconds;
+    for (int i = 0; i < connections; i++) {
+        if (!sendBatch(clients[i], pipeline, keys, reads, averages)) {
+            cerr << "Lost the server.\n";
+            return 1;
+        }
+        watch(epoll, clients[i], i);
+    }
+    int busy = connections; //how many clients still have a batch out
+    epoll_event events[256];
+    char chunk[64 << 10];
+    while (busy > 0) {
+        int ready = epoll_wait(epoll, events, 256, 1000);
+        for (int e = 0; e < ready; e++) {
+            Client& client = clients[events[e].data.u32];
+            if (events[e].events & EPOLLOUT && !sendSome(client)) {
+                cerr << "Lost the server.\n";
+                return 1;
+            }
+            ssize_t got = ::read(client.fd, chunk, sizeof(chunk));
+            if (got == 0 || (got < 0 && errno != EAGAIN && errno != EINTR)) {
+                cerr << "Lost the server.\n";
+                return 1;
+            }
+            double arrived = now();
+            if (got > 0 && !client.partial.empty() && client.partial.size() < 3) { //the cut off answer was too short to tell yet, so top it up
+                const char* newline = (const char*)memchr(chunk, '\n', got);
+                size_t line = newline == NULL ? got : newline - chunk;
+                client.partial.append(chunk, min(line, 3 - client.partial.size()));
+            }
+            for (ssize_t at = 0, lineStart = 0; at < got; at++) { //every newline is one more answer
+                if (chunk[at] != '\n') {
+                    continue;
+                }
+                bool error = client.partial.empty() ? at - lineStart >= 3 && memcmp(chunk + lineStart, "ERR", 3) == 0 :
+                                                      client.partial.compare(0, 3, "ERR") == 0; //the answer started in an earlier read
+                errors += error;
+                client.partial.clear();
+                lineStart = at + 1;
+                latencies.push_back((arrived - client.sentAt) * 1e6);
+                client.waiting--;
+            }
+            if (got > 0 && chunk[got - 1] != '\n') { //keeps the start of a cut off answer so we can still tell if it's an ERR
+                const char* last = (const char*)memrchr(chunk, '\n', got);
+                if (last != NULL || client.partial.empty()) { //otherwise it's still the answer partial has, which got topped up already
+                    size_t from = last == NULL ? 0 : last - chunk + 1;
+                    client.partial.append(chunk + from, min((size_t)got - from, (size_t)3));
+                }
+            }
+            if (client.waiting == 0) {
+                if (arrived >= end) {
+                    busy--; //done, just stays connected until the end
+                } else if (!sendBatch(client, pipeline, keys, reads, averages)) {
+                    cerr << "Lost the server.\n";
+                    return 1;
+                }
+            }
+            watch(epoll, client, events[e].data.u32);
+        }
+    }
+    double elapsed = now() - start;
+    for (Client& client : clients) {
+        close(client.fd);
+    }
+    close(epoll);
+
+    sort(latencies.begin(), latencies.end());
+    cout << fixed << setprecision(1) << connections << " connections, " << pipeline << " commands per batch, " << elapsed << "s\n"
+         << "  " << latencies.size() << " commands answered, " << setprecision(0) << latencies.size() / elapsed << " ops/sec ("
+         << errors << " ERR answers)\n" << setprecision(1)
+         << "  latency p50 " << percentile(latencies, 0.5) << "us, p99 " << percentile(latencies, 0.99) << "us, p99.9 "
+         << percentile(latencies, 0.999) << "us, max " << (latencies.empty() ? 0 : latencies.back()) << "us\n";
+}
@@ -0,0 +1,240 @@
+/* Benchmark suite for the table primitives, for tracking regressions from one version to the next. Unlike bench/benchmark.cpp, which prints
+*  tables for people to read, this one prints CSV (one row per measurement) so the results can be saved and compared with a script.
+*  Build it with make suite, or make bench to build it and save a run into bench-<version>.csv.
+*
+*  Run it with any of --min=<keys> and --max=<keys> (default 1000 and 1000000, the sizes go up by 10x, the biggest the suite knows is
+*  100000000 but that needs way more memory than 8 GB for the chained table), --hash=sha3|wyhash|mix|all (default mix) and --tables=<list>
+*  (chained, flat, and unordered_map separated by commas, default all three). For every table, hasher, key distribution and size it times:
+*    insert     inserting every key into an empty table, so it includes every resize along the way (placeNode and reHash)
+*    rehash     doubling the full table once, by reserving twice the buckets and finishing the resize right away (reHash on its own)
+*    find_hit   finding every key, in a shuffled order (deHash and the chain walk)
+*    find_miss  finding as many keys that aren't there
+*    erase      erasing every key, in another shuffled order (the deleteNode logic)
+*  The key distributions are sequential (1, 2, 3, ...), random (distinct but all over the place) and adversarial (the keys only differ in
+*  their top bits, which is the worst case for any hasher that doesn't mix the top bits down into the index). std::unordered_map is there
+*  as the baseline, with the same hasher so the difference is all in the table. The columns are:
+*    version,table,hasher,distribution,keys,operation,ns_per_op,bytes_per_key
+*  where version is what git describe said when it was built, and bytes_per_key is everything the table has allocated (from malloc's own
+*  count) divided by the amount of keys in it, measured right after the insert.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <malloc.h>
+#include "../Student.h"
+#include "../Hashers.h"
+#include "../HashTable.h"
+#include "../FlatTable.h"
+using namespace std;
+
+#ifndef BENCH_VERSION
+#define BENCH_VERSION "unknown" //the Makefile passes git describe in here
+#endif
+
+//the current time in seconds, for timing things
+double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//how many bytes malloc has handed out right now, including the big blocks it mmaps (like the bucket arrays)
+size_t allocated() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+enum Distribution { SEQUENTIAL, RANDOM, ADVERSARIAL };
+const char* DISTRIBUTION_NAMES[] = {"sequential", "random", "adversarial"};
+
+//the i'th key of the distribution. Every distribution gives distinct keys for distinct i, so keys n and up are never among the first n
+int makeKey(Distribution distribution, uint32_t i) {
+    if (distribution == SEQUENTIAL) {
+        return i + 1;
+    } else if (distribution == RANDOM) { //an odd multiply and xorshifts, which can be undone, so no two i give the same key
+        uint32_t x = i * 0x9e3779b1u;
+        x ^= x >> 15;
+        x *= 0x85ebca6bu;
+        return x ^ (x >> 13);
+    }
+    return (i << 16) | (i >> 16); //rotated, so the first 65536 keys all have the same bottom 16 bits
+}
+
+//std::unordered_map wants a size_t out of its hasher, this hands it ours
+template <class Hasher>
+struct StdHasher {
+    size_t operator()(int key) const {
+        return hasher(key);
+    }
+    Hasher hasher;
+};
+
+//wraps std::unordered_map in the same interface as our tables, so the same timing code works for all of them
+template <class Hasher>
+class StdTable {
+public:
+    bool insert(int key, const Student& value) {
+        return map.emplace(key, value).second;
+    }
+    Student* find(int key) {
+        typename unordered_map<int, Student, StdHasher<Hasher> >::iterator it = map.find(key);
+        return it == map.end() ? NULL : &it->second;
+    }
+    bool erase(int key) {
+        return map.erase(key) > 0;
+    }
+    void doubleOnce() {
+        map.rehash(map.bucket_count() * 2);
+    }
+private:
+    unordered_map<int, Student, StdHasher<Hasher> > map;
+};
+
+//doubling the table once, which every table does its own way
+template <class Hasher>
+void doubleOnce(HashTable<int, Student, Hasher>& table) {
+    table.reserve(table.bucketCount() * 2);
+    table.finishResize();
+}
+template <class Hasher>
+void doubleOnce(FlatTable<int, Student, Hasher>& table) {
+    table.reserve(table.capacity()); //needs more than the capacity to stay under the load factor, so it has to double
+}
+template <class Hasher>
+void doubleOnce(StdTable<Hasher>& table) {
+    table.doubleOnce();
+}
+
+//prints one row of results
+void report(const string& table, const char* hasher, Distribution distribution, size_t keys, const char* operation, double seconds, double bytesPerKey) {
+    printf("%s,%s,%s,%s,%zu,%s,%.2f,%.1f\n", BENCH_VERSION, table.c_str(), hasher, DISTRIBUTION_NAMES[distribution], keys, operation,
+           seconds * 1e9 / keys, bytesPerKey);
+    fflush(stdout); //so a run that gets killed for running out of memory still has every row before it
+}
+
+//runs every operation on a fresh table of the given type with the given keys
+template <class Table>
+void benchTable(const string& name, const char* hasher, Distribution distribution, size_t keys) {
+    vector<int> present(keys); //the keys that go in
+    vector<int> absent(keys); //keys that never go in
+    for (size_t i = 0; i < keys; i++) {
+        present[i] = makeKey(distribution, i);
+        absent[i] = makeKey(distribution, i + keys);
+    }
+    vector<int> shuffled = present; //the same keys in another order, so finding them doesn't just follow the order they went in
+    mt19937 random(keys);
+    shuffle(shuffled.begin(), shuffled.end(), random);
+    string first = "Harry"; //the names go into the shared name pool once, so they add nothing per key
+    string last = "Table";
+    size_t found = 0; //adds up the results so the compiler can't skip the finds
+
+    size_t before = allocated();
+    Table* table = new Table();
+    double start = now();
+    for (int key : present) {
+        table->insert(key, Student(first, last, key, 0));
+    }
+    double time = now() - start;
+    double bytesPerKey = (double)(allocated() - before) / keys;
+    report(name, hasher, distribution, keys, "insert", time, bytesPerKey);
+
+    start = now();
+    doubleOnce(*table);
+    report(name, hasher, distribution, keys, "rehash", now() - start, (double)(allocated() - before) / keys);
+
+    start = now();
+    for (int key : shuffled) {
+        found += table->find(key) != NULL;
+    }
+    report(name, hasher, distribution, keys, "find_hit", now() - start, bytesPerKey);
+
+    start = now();
+    for (int key : absent) {
+        found += table->find(key) != NULL;
+    }
+    report(name, hasher, distribution, keys, "find_miss", now() - start, bytesPerKey);
+
+    shuffle(shuffled.begin(), shuffled.end(), random);
+    start = now();
+    for (int key : shuffled) {
+        found -= table->erase(key);
+    }
+    report(name, hasher, distribution, keys, "erase", now() - start, bytesPerKey);
+    delete table;
+
+    if (found != 0) { //every key found got erased and nothing absent got found, so it always comes out to 0
+        cerr << name << " lost keys with " << DISTRIBUTION_NAMES[distribution] << " keys!\n";
+        exit(1);
+    }
+}
+
+//runs every picked table and distribution at every size with the given hasher
+template <class Hasher>
+void benchHasher(const vector<string>& tables, size_t minKeys, size_t maxKeys) {
+    for (size_t keys = minKeys; keys <= maxKeys; keys *= 10) {
+        for (int d = SEQUENTIAL; d <= ADVERSARIAL; d++) {
+            Distribution distribution = (Distribution)d;
+            cerr << Hasher::name() << ", " << DISTRIBUTION_NAMES[d] << ", " << keys << " keys\n"; //progress, out of the way of the results
+            for (const string& table : tables) {
+                if (table == "chained") {
+                    benchTable<HashTable<int, Student, Hasher> >(table, Hasher::name(), distribution, keys);
+                } else if (table == "flat") {
+                    benchTable<FlatTable<int, Student, Hasher> >(table, Hasher::name(), distribution, keys);
+                } else {
+                    benchTable<StdTable<Hasher> >(table, Hasher::name(), distribution, keys);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t minKeys = 1000;
+    size_t maxKeys = 1000000;
+    string hasher = "mix";
+    vector<string> tables = {"chained", "flat", "unordered_map"};
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.compare(0, 6, "--min=") == 0) {
+            minKeys = atof(arg.c_str() + 6); //atof so 1e6 works too
+        } else if (arg.compare(0, 6, "--max=") == 0) {
+            maxKeys = atof(arg.c_str() + 6);
+        } else if (arg == "--hash=sha3" || arg == "--hash=wyhash" || arg == "--hash=mix" || arg == "--hash=all") {
+            hasher = arg.substr(7);
+        } else if (arg.compare(0, 9, "--tables=") == 0) {
+            tables.clear();
+            for (size_t start = 9, end; start <= arg.size(); start = end + 1) {
+                end = min(arg.find(',', start), arg.size());
+                tables.push_back(arg.substr(start, end - start));
+                if (tables.back() != "chained" && tables.back() != "flat" && tables.back() != "unordered_map") {
+                    cerr << "Unknown table \"" << tables.back() << "\". (valid tables are chained, flat and unordered_map)\n";
+                    return 1;
+                }
+            }
+        } else {
+            cerr << "Unknown argument \"" << arg << "\". (valid arguments are --min=<keys>, --max=<keys>, --hash=sha3|wyhash|mix|all and --tables=<list>)\n";
+            return 1;
+        }
+    }
+    if (minKeys < 1 || maxKeys > 100000000) {
+        cerr << "The sizes have to be between 1 and 100000000 keys.\n";
+        return 1;
+    }
+
+    printf("version,table,hasher,distribution,keys,operation,ns_per_op,bytes_per_key\n");
+    if (hasher == "sha3" || hasher == "all") {
+        benchHasher<SHA3Hasher>(tables, minKeys, maxKeys);
+    }
+    if (hasher == "wyhash" || hasher == "all") {
+        benchHasher<WyHasher>(tables, minKeys, maxKeys);
+    }
+    if (hasher == "mix" || hasher == "all") {
+        benchHasher<MixHasher>(tables, minKeys, maxKeys);
+    }
+}
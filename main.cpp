@@ -1,414 +1,945 @@
-/* Tomas Carranza Echaniz
-*  1/29/2026
-*  This program is a student database that uses a hash table which handles collisions using chaining. Chains have a maximum
-*  length of 3. When this is exceeded, the hash table length is doubled and all the nodes are rehashed. The hash algorithm
-*  used is SHA-3; all nodes are assigned a hash on creation based on their student ID. The user can ADD a new student, which
-*  will be added to the table according to its hash. You can DELETE the student, and PRINT all the students' data. You can
-*  also print the AVERAGE of all their GPAs, ask for HELP to print all the valid commands, or QUIT the program. The user can
-*  also RELOAD the name files if necessary.
-*
-*  Hash tables are efficient because you don't have to iterate across every student to check if they have the right ID,
-*  you just plug in the ID and it gives you the index!
-*/
-
-#include <iostream>
-#include <limits>
-#include <cstring>
-#include <iomanip>
-#include <string>
-#include <fstream>
-#include <cstdlib>
-#include <ctime>
-#include <vector>
-#include <algorithm>
-#include <cctype>
-#include "Student.h"
-#include "Node.h"
-#include "SHA3.h"
-using namespace std;
-
-//for ignoring faulty input and extra characters, functionality taken from my previous projects
-void CinIgnoreAll(bool force = false) {
-    if (!cin || force) { //only go if input is faulty, otherwise forces the user to input an extra enter
-        cin.clear(); //clears error flag
-        cin.ignore(numeric_limits<streamsize>::max(), '\n'); //ignores all characters up until a new line
-    }
-}
-
-//capitalizes the given string for easier command interpretation
-void AllCaps(string& word) {
-    for (size_t i = 0; i < word.size(); i++) { //sets all the characters to a capitalized unsigned version of the char (unsigned because some systems sign the chars)
-        word[i] = toupper((unsigned char)word[i]);
-    }
-}
-
-//for getting an integer from the player, ususally the id of a student
-int makeNum(bool id = true) { //id bool is for giving id error or normal error
-    int num = 0;
-    while (true) {
-        cout << "\n> ";
-        cin >> num; //gets the integer
-        if (cin) { //return the number and end the loop if input was valid
-            CinIgnoreAll(true); //removes the newline character after valid integer input
-            return num;
-        } else { //otherwise give error message and try again
-            if (id) { //id-specific error "\nID must be an integer."
-                cout << "\nID m";
-            } else { //generic integer error "\nMust be an integer."
-                cout << "\nM";
-            }
-            cout << "ust be an integer.";
-        }
-        CinIgnoreAll(); //removes the newline character or invalid input
-    }
-}
-
-//checks the table for if it's empty based on if it's all NULL nodes
-bool getEmpty(Node** table, size_t tablelen) {
-    for (size_t i = 0; i < tablelen; i++) { //iterates through the table, returns false, table is not empty, upon reaching a non-NULL node
-        if (table[i] != NULL) {
-            return false;
-        }
-    } //return true, table is empty, if no non-NULL nodes were found
-    return true;
-}
-
-//get an index in the hash table based on the given hash and table length, based on Absorb() in SHA3.cpp
-size_t deHash(const string& hash, size_t tablelen) {
-    size_t index = 0; //create an index
-    //de-stringifies hash so we can use the bytes
-    const uint8_t* hashBytes = reinterpret_cast<const uint8_t*>(&hash[0]);
-    size_t hashSize = hash.size(); //the full size of the hash
-    //the amount of bytes size_t takes up (the size of size!)
-    const size_t sizesize = sizeof(size_t);
-
-    while (hashSize > 0) { //xors the hash into the index in size-sized chunks (so we don't just waste the rest of the hash we worked so hard to make)
-        size_t hashChunk = 0; //creates an empty chunk to memcpy into
-        size_t chunkSize = min(hashSize, sizesize); //get the size of the chunk (sizesize for everything except the end of the hash, so we don't go over the end of hash if hashSize%sizesize != 0)
-        memcpy(&hashChunk, hashBytes, chunkSize); //get the chunkSize-sized chunk of the hash
-        index ^= hashChunk; //xor the chunk into the index
-        hashBytes += chunkSize; //advance the hash pointer forward so we read the next chunk next loop
-        hashSize -= chunkSize; //subtract from the hashSize so we know how big the last chunk is when we get there
-    } //xors the index's top half into the bottom half so that both halves matter equally in the final modulo, because otherwise the top half wouldn't matter as much
-    index ^= index >> sizesize*4+1; //we use that amount cause bitshift uses bit amounts, and 8 bits = 1 byte, and we want to shift it by half, so we multiply by 4, and then we add one to reduce symmetry. sizesize*4+1 is computed before >>
-    //mix the index with Knuth's constant, well known for de-linearizing hashes (so more random, less collisions). SHA-3 is very good at hashing, but since we fold it so much a lot of the entropy is gone, so we also do this
-    index *= 11400714819323198485ULL;
-    return index % tablelen; //modulo the index based on tablelen to stay within bounds and return that
-}
-
-//place the node into the hash table at the given index and return true if we need to rehash, based on chain length
-bool placeNode(Node* node, Node** table, size_t index) {
-    if (table[index] == NULL) { //if the bucket at the given index is empty, we just tell the table in main the node goes here
-        table[index] = node;
-        return false; //no need to rehash because the chain length is 1 guaranteed!
-    }
-    Node* current = table[index]; //finds the beginning node
-    int chainlen = 2; //how long the chain is, starts at 2 because it includes the first and (new) last nodes
-    for (; current->getNext() != NULL;) { //iterate through the chain until we reach the last node
-        current = current->getNext(); //go to the next node
-        chainlen++; //increment the chain length since we checked one more node
-    }
-    current->setNext(node); //places the node after the previous last node
-    return chainlen > 3; //if the chain length exceeds 3, we say to rehash
-}
-
-//double the table size and rearrange all the nodes in into new buckets, when we exceed the maximum chain length of 3
-void reHash(Node**& table, size_t& tablelen) {
-    vector<Node*> nodes; //vector of all nodes which they're chucked into until they're all rehashed
-    for (size_t i = 0; i < tablelen; i++) { //iterates through table indices
-        for (Node* current = table[i]; current != NULL; current = current->getNext()) { //starting at the current node, iterates through the chain until it reaches the NULL end
-            nodes.push_back(current); //add the current node to the nodes vector
-        }
-    }
-    //continues looping until we successfully rehash (usually this just runs once, but this accounts for the unlikely edge case of accidentally creating another 4 chain while rehashing)
-    for (bool continuing = true; continuing;) {
-        delete[] table; //deletes the old overcrowded hash table
-        for (Node* node : nodes) { //nullify all node linkages since they're gonna be in different buckets now
-            node->setNext(NULL);
-        }
-        tablelen *= 2; //double the hash table length and create a new shiny hash table with the new length
-        table = new Node*[tablelen](); //the new shiny hash table
-        continuing = false; //assume success to start
-        for (Node* node : nodes) { //sort all the nodes into the new hash table based on their hash and the new length
-            size_t i = deHash(node->getHash(), tablelen); //gets the index based on the hash
-            if (placeNode(node, table, i)) { //puts the node in the new spot and checks for a chain length greater than 3
-                continuing = true; //if we detect too long a chain, we must do all that again, so we continuing!
-                break; //break, no need to sort the rest of the nodes if we're just gonna unsort them immediately
-            }
-        }
-    }
-}
-
-//reads the data from a text file into a vector of strings (each line in the file is an item in the vector)
-void readTxtData(const string& file, vector<string>& lines) { //needs the name of the file and the vector to write into
-    lines.clear(); //removes any existing data from the given vector, so we don't just inflate it on every RELOAD
-    ifstream txt(file); //opens the file
-    if (!txt) { //says error message if we couldn't open the file for some reason
-        cout << "\nError encountered while opening " << file << ".";
-    } //no need to return because it just fails the for loop condition immediately and then the function ends anyway
-    //reads each line from txt and adds them to the vector of lines
-    for (string line; getline(txt, line); lines.push_back(line));
-}
-
-//takes the two names vectors and reads the associated files into them, (item in vector = line in file)
-void loadNames(vector<string>& firstnames, vector<string>& lastnames, bool initial = false) {
-    readTxtData("firstnames.txt", firstnames); //reads the files into their corresponding vectors
-    readTxtData("lastnames.txt", lastnames);
-    bool faulty1 = firstnames.empty(); //gives errors if the vectors are empty for whatever reason
-    bool faulty2 = lastnames.empty();
-    if (faulty1 && faulty2) { //gives specific error, which one or if both files are faulty/empty
-        cout << "\nList of first and last names empty. GENERATE command disabled."; //both faulty
-    } else if (faulty1) { //first names faulty
-        cout << "\nList of first names empty. GENERATE command disabled.";
-    } else if (faulty2) { //last names faulty
-        cout << "\nList of last names empty. GENERATE command disabled.";
-    } else if (!initial) { //otherwise, success text! (unless it's the first one, because that runs without player input, so they don't need to know)
-        cout << "\nSuccessfully reloaded first and last name lists!";
-    }
-}
-
-//creates a new student and a new node pointing to it, needs the table as input so we can make sure to not repeat IDs, because that would cause infinite rehashing (since upon reaching 3 collisisons, the same 4 nodes would be rehashed into the same bucket again)
-Node* createStudent(Node** table, size_t tablelen) {
-    string firstname;
-    string lastname;
-    int id;
-    float gpa;
-
-    //get the student's first (and middle if applicable) names
-    cout << "\nEnter first (and middle) name for new student.\n> ";
-    getline(cin, firstname);
-
-    //get the student's last name(s)
-    cout << "\nEnter last name(s) for new student.\n> ";
-    getline(cin, lastname);
-
-    //get the student's ID
-    cout << "\nEnter " << firstname << "'s student ID.";
-    bool continuing = true; //continues until valid input is given
-    while (continuing) {
-        id = makeNum(); //gets the ID using the number getting function, "\n> " is provided there
-        continuing = false; //assumes valid input to start since makeNum doesn't return faulty input
-        size_t i = deHash(SHA3::Hash(id), tablelen); //gets the index that the given ID would be placed at
-
-        //iterates through the chain at index i and goes to the next one each iteration until it meets a null node, that being the end
-        for (Node* current = table[i]; current != NULL; current = current->getNext()) { //in order to check if the currently considered ID is taken for reasons stated above the createStudent function
-            if (current->getStudent()->getID() == id) { //if the IDs match that's bad
-                continuing = true; //we keep continuing and get a new ID from the user because the IDs conflict
-                Student* student = current->getStudent(); //get the student so we don't getStudent() twice
-                cout << "\nID " << id << " is taken by " << student->getName(0) << " " << student->getName(1) << "."; //error message; shows who is causing the conflict
-                break; //break since we know there's a conflict alredy so more checks would waste valuable time
-            }
-        }
-    }
-
-    //get the student's gpa
-    cout << "\nEnter " << firstname << "'s GPA.";
-    for (continuing = true; continuing;) { //continues until valid input is given
-        cout << "\n> ";
-        cin >> gpa; //gets the gpa float
-        if (cin) { //end loop if valid input was given
-            continuing = false;
-        } else { //error message otherwise
-            cout << "\nGPA must be a float.";
-        }
-        CinIgnoreAll(true); //removes the newline character of invalid input
-    }
-
-    //creates a new student using the given data
-    Student* student = new Student(firstname, lastname, id, gpa);
-    //create and return a new node pointing to the new student, featuring a hash generated using the ID
-    return new Node(student, SHA3::Hash(id));
-}
-
-//pseudorandomly generate a student using the name files, the stored genID, and a GPA between 0 and 4.5
-void generateStudent(Node**& table, size_t& tablelen, vector<string>& firstnames, vector<string>& lastnames, int& genID) {
-    string firstname = firstnames[rand()%firstnames.size()]; //use the lists to choose one of each type of name
-    string lastname = lastnames[rand()%lastnames.size()];
-
-    int id; //the ID this student will have, we get it by incrementing genID until we find an unused ID
-    size_t index; //the bucket of the hash table the student will be placed into
-    string hash; //the student's hash based on the ID
-
-    for (bool continuing = true; continuing;) { //continues until valid ID is found
-        id = genID++; //gets the next ID and then increments it (the one in main())
-        hash = SHA3::Hash(id); //gets the hash of the new ID
-        continuing = false; //assumes valid ID to start
-        index = deHash(hash, tablelen); //gets the index that the given ID would be placed at
-
-        //iterates through the chain at index i and goes to the next one each iteration until it meets a null node, that being the end
-        for (Node* current = table[index]; current != NULL; current = current->getNext()) { //in order to check if the currently considered ID is taken for reasons stated above the createStudent function
-            if (current->getStudent()->getID() == id) { //if the IDs match that's bad
-                continuing = true; //we keep continuing and get a new ID because the IDs conflict
-                break; //break since we know there's a conflict alredy so more checks would waste valuable time
-            }
-        }
-    } //generates a random gpa between 0.0 and 4.5
-    float gpa = (rand()%450)/100.0;
-
-    //creates a new student and node using the generated data
-    Student* student = new Student(firstname, lastname, id, gpa);
-    Node* node = new Node(student, hash);
-    
-    //place the student at the found index
-    if (placeNode(node, table, index)) { //if placeNode says we exceeded the chain length limit, we rehash!
-        reHash(table, tablelen);
-    }
-}
-
-//get an amount from the player, and then generate that many new students
-void initGeneration(Node**& table, size_t& tablelen, vector<string>& firstnames, vector<string>& lastnames, int& genID) {
-    if (!firstnames.size() || !lastnames.size()) { //if our name lists are empty due to file issues, we can't generate any students
-        cout << "\nNo valid names available; can't generate students."; //so we give an error and return, no generating allowed
-        return;
-    }
-    cout << "\nHow many students to generate?";
-    int amount = makeNum(false); //gets how many students to generate
-    cout << "\n"; //formatting!
-    for (int i = 0; i < amount; i++) { //generates as many students as specified
-        generateStudent(table, tablelen, firstnames, lastnames, genID);
-        cout << "\rProgress: " << i * 100.0 / amount << "%" << flush; //prints the progress percentage in float form, for very large amounts (also overwrites the last percentage printing, looks more progress bar-y that way)
-    }
-    cout << "\rSuccessfully generated " << amount << " student"; //overwrites the progress indicator with the success message! (looks better by overwriting rather than a new line)
-    if (amount != 1) { //make it plural if it wasn't specifically 1 student
-        cout << "s";
-    }
-    cout << "!"; //exclamation mark!
-}
-
-//creates a new student node which the player can manually set the values for, and inserts it into the hash table
-void makeStudent(Node**& table, size_t& tablelen) {
-    Node* newguy = createStudent(table, tablelen); //create the student with all their values and get their node
-    size_t index = deHash(newguy->getHash(), tablelen); //find where to put the student node
-    //try to place the student; if doing so creates a chain longer than 3 nodes, we rehash the hash table!
-    if (placeNode(newguy, table, index)) {
-        reHash(table, tablelen); //rehash the hash table!
-    } //success text!
-    cout << "\nSuccessfully created " << newguy->getStudent()->getName(0) << "!";
-}
-
-//prints the given student (with option to put the data in a new line)
-void printStudent(Student* student, bool newline = true) {
-    if (newline) { //prints the new line if we need to
-        cout << "\n";
-    } //prints all the student's data
-    cout << student->getName(0) << " " << student->getName(1) << " (" << student->getID() << ") - GPA of " << student->getGPA();
-}
-
-//uses id to find and delete a node in the hash table
-void deleteNode(Node** table, size_t tablelen) {
-    cout << "\nEnter ID of student to delete.";
-    int id = makeNum(); //gets the ID from the player to search for
-    size_t index = deHash(SHA3::Hash(id), tablelen); //creates a hash based on the ID and immediately dehashes it to get an index to start searching in
-
-    Node* previous = NULL; //we store the previous node so we can bridge the gap created by deleting middle or end nodes
-    //check the chain starting from the index position in the table, continue until going off the end of the chain (entering NULL territory)
-    for (Node* current = table[index]; current != NULL; current = current->getNext()) {
-        if (current->getStudent()->getID() == id) { //delete the node if its student's ID matches
-            if (current == table[index]) { //if it's the first one in the chain, update the table in main() by bringing the next node into the table at the index
-                table[index] = current->getNext();
-            } else { //if it's the middle or end one, bridge the gap by setting previous's next to the deleted node's next (1 -> 2 -> 3)  ==>  (1 ->   -> 3)  ==>  (1 -> 3)
-                previous->setNext(current->getNext());
-            }
-            Student* student = current->getStudent(); //avoids extra student getting
-            cout << "\nDeleted " << student->getName(0) << " " << student->getName(1) << "."; //deletion success text!
-            delete current; //deletes the student
-            return; //returns because there's nothing else to do here
-        }
-        previous = current; //updates previous, because the next current's previous is going to be current
-    } //error, no student with ID id found
-    cout << "\nNo student found with ID " << id << ".";
-}
-
-//prints the average gpa of all the students
-void average(Node** table, size_t tablelen) {
-    double sum = 0; //the sum of all gpas, double for extra precision in case we have like a million students
-    int count = 0; //how many students in table
-    for (size_t i = 0; i < tablelen; i++) { //iterates through table indices
-        for (Node* current = table[i]; current != NULL; current = current->getNext()) { //starting at the current node, iterates through the chain until it reaches the NULL end
-            sum += current->getStudent()->getGPA(); //add the gpa to the sum total
-            count++; //increment the count because there's one more student to count
-        }
-    }
-    if (!count) { //if we didn't find anyone, we give error message and return
-        cout << "\nThere are no students with GPAs to average. (type ADD for add)";
-        return;
-    } //print the average gpa to two decimals of precision
-    cout << "\nAverage GPA: " << sum / count;
-}
-
-//print all the students' data by iterating through the table and iterating through any chains it finds
-void printAll(Node** table, size_t tablelen) {
-    if (getEmpty(table, tablelen)) { //check if there's any students to print
-        cout << "\nThere are no students to print."; //if not, error and return
-        return;
-    }
-    cout << "\nStudents:";
-    for (size_t i = 0; i < tablelen; i++) { //iterates through table indices
-        for (Node* current = table[i]; current != NULL; current = current->getNext()) { //starting at the current node, iterates through the chain until it reaches the NULL end
-            printStudent(current->getStudent()); //prints the current student data
-        }
-    }
-}
-
-//the main loop
-int main() {
-    size_t tableLen = 100; //the length of the hash table which gets doubled when chain length exceeds 3 on the same index
-    Node** table = new Node*[tableLen](); //the hash table of linked list chains
-
-    vector<string> firstNames; //the vectors of names that are used to pseudorandomly generate students
-    vector<string> lastNames;
-
-    int genID = 1; //the ID used when randomly generating a student, gets incremented after every generation
-
-    srand(time(NULL)); //seed the random number generation with the time, so the random student generation can use it
-
-    //welcome message with instructions, also sets float printings to 2 decimal points of precision
-    cout << "\nHello I am Harry the hash table!\nI am managing a database of students.\nType HELP for help." << fixed << setprecision(2);
-    loadNames(firstNames, lastNames, true); //loads the names from the files "firstnames.txt" and "lastnames.txt"
-    cout << "\n\nThere are currently no students. (type ADD for add)";
-    
-    string command; //the command that the user inputs into (now outside the loop! how exciting!)
-    //continues until continuing is falsified (by typing QUIT)
-    for (bool continuing = true; continuing;) {
-        cout << "\n> "; //thing for the player to type after
-        
-        getline(cin, command); //gets the player input, up to 255 characters
-        
-        AllCaps(command); //capitalizes the command for easier interpretation
-        
-        //calls function corresponding to the given command word
-        if (command == "ADD") { //add student
-            makeStudent(table, tableLen);
-        } else if (command == "GENERATE") { //randomly generate new student(s)
-            initGeneration(table, tableLen, firstNames, lastNames, genID);
-        } else if (command == "DELETE") { //delete student
-            deleteNode(table, tableLen);
-        } else if (command == "PRINT") { //print all students
-            printAll(table, tableLen);
-        } else if (command == "AVERAGE") { //print average gpa of all students
-            average(table, tableLen);
-        } else if (command == "RELOAD") { //reload name files
-            loadNames(firstNames, lastNames);
-        } else if (command == "HELP") { //print all valid command words
-            cout << "\nYour command words are:\nADD      - Manually create a new student.\nGENERATE - Randomly generate a given amount of students.\nDELETE   - Delete an existing student by ID.\nPRINT    - Print the data of all students.\nAVERAGE  - Calculate the average GPA of all students.\nRELOAD   - Reload the two name files.\nHELP     - Print all valid commands.\nQUIT     - Exit the program.";
-        } else if (command == "QUIT") { //quit the program
-            continuing = false; //leave the main player loop
-        } else { //give error message if the user typed something unacceptable
-            cout << "\nInvalid command \"" << command << "\". (type HELP for help)";
-        }
-    }
-
-    //says bye
-    cout <<"\nPeace out.\n";
-
-    //deletes all the nodes for good practice, iterates through the table and from there iterates through the individual chains
-    for (size_t i = 0; i < tableLen; i++) {
-        Node* next = NULL; //stores the next node temporarily so we can delete the current one
-        for (Node* current = table[i]; current != NULL; current = next) { //starts at the first node in bucket i and iterates through until the end of the chain
-            next = current->getNext(); //go to the next node
-            delete current; //deletes the node
-        }
-    }
-
-    delete[] table; //deletes the table structure itself
-}
+/* Tomas Carranza Echaniz
+*  1/29/2026
+*  This program is a student database that uses a hash table which handles collisions using chaining. When there are more
+*  students than buckets (or a chain gets longer than 3 while the table is at least half full), the hash table length is doubled
+*  and all the nodes are rehashed, and when deleting leaves it less than 1/8 full, it's halved again to give the memory back. The hash algorithm
+*  used is SHA-3; all nodes are assigned a hash on creation based on their student ID. The user can ADD a new student, which
+*  will be added to the table according to its hash. You can DELETE the student, and PRINT all the students' data. You can
+*  also print the AVERAGE of all their GPAs (along with the lowest, highest, and how spread out they are), ask for HELP to print all the valid commands, or QUIT the program. The user can
+*  also RELOAD the name files if necessary, and see what's going on inside the table with STATS (load factor, chain lengths, how long
+*  lookups probe, how often and how long the table resized, how much memory shrinking it gave back, and where the time of an insert goes).
+*
+*  The tables themselves are templates in HashTable.h and FlatTable.h, and this file is just the command line interface for
+*  them, wrapped in the StudentTable from StudentTable.h, which keeps every GPA in a column of its own with running totals so the
+*  AVERAGE is instant no matter how many students there are. The table engine can be picked when starting the program: the default is the chained table described above, but running it
+*  with --engine=flat uses the FlatTable instead, which uses open addressing and stores the students inline, checking 16
+*  slots at a time with SIMD. The hasher can be picked too: --hash=sha3 is the default, but --hash=wyhash and --hash=mix use fast
+*  non-cryptographic 64-bit mixers instead, which are way cheaper than SHA-3 for just hashing an int. --buckets=<amount> sets how big
+*  the table starts out (128 by default), which is also the smallest it ever shrinks back down to.
+*  Generating a lot of students at once (100000 or more) takes a bulk path that presizes the table and generates, hashes, and
+*  links the students on every core at the same time. The whole database can be SAVEd into a binary snapshot file and LOADed back
+*  later, which replaces whatever students there are with the ones in the file. Running it with --journal=<file> journals every
+*  change into that file so nothing is lost on QUIT (or a crash), and the students are all back the next time it's run with the same
+*  journal. --fsync=always waits for every change to hit the disk, --fsync=never leaves that up to the OS, and --fsync=<ms> (the
+*  default is 100) writes the changes out together every that many milliseconds.
+*
+*  For scripts there's a batch mode: --batch reads commands from stdin (or --batch=<file> from a file), one per line, with everything
+*  the command needs on the same line (ADD <first> <last> <id> <gpa>, DELETE <id>, GENERATE <amount>, PRINT, AVERAGE, SAVE <file>,
+*  LOAD <file>, QUIT). Nothing gets prompted for, and every command answers with one line, OK (and the result) or ERR and what went wrong.
+*  GET <id> answers with the student's names and GPA, GET <id> <id> ... answers like PRINT with just the ones of those IDs that exist (they're
+*  looked up all together, with their cache misses overlapping, so that's faster than a GET for each), and STATS answers with every table statistic as name=value pairs. AVERAGE <low> <high>
+*  only averages the GPAs from low to high and answers with the average and how many there were. LASTNAME <name> and RANGE <low> <high>
+*  answer like PRINT with just the students with that last name or a GPA in that range. They walk every student, unless it's run with
+*  --index, which keeps a hash index of last names and a sorted index of GPAs so they only take as long as the amount of students they find.
+*  SCAN <cursor> [<count>] pages through the students instead of PRINTing all of them at once: it answers with about count students (100 if
+*  it isn't given) and then OK and the cursor to send next time, starting from 0 and until it answers with a cursor of 0 again. Every
+*  student that's there the whole time gets answered at least once, even if others get added and the table grows in between.
+*  VIEW opens a point-in-time view of every student and answers with its number, and READ <view> [<count>] pages through it like SCAN,
+*  answering with about count students and then OK and how many the view has left, until that's 0 and the view closes itself (CLOSE <view>
+*  closes it before that). A view answers with exactly the students there were when it was opened, each of them once, however much gets
+*  added or deleted in between (even by other clients of the server). Opening one doesn't copy anything, a student only gets copied into
+*  the view if they're deleted before the view got to them (see ReadView.h), and the table doesn't shrink while a view is open.
+*  --filter puts a cuckoo filter in front of the table, which answers most lookups of IDs that aren't there (DELETEs and GETs of nobody, and
+*  checking if an ID is taken) without hashing the ID or looking in the table.
+*  FREEZE (in both modes) builds a read-only copy of every student with a minimal perfect hash over the IDs (see FrozenTable.h), and every
+*  lookup uses that instead of the table until the next ADD, DELETE, GENERATE or LOAD. Building it takes 0.3 to 0.4 seconds per million
+*  students, and it takes about 20.8 bytes per student on top of the table.
+*
+*  --serve=<socket> makes it a server instead: other processes on the same machine connect to the Unix socket at that path and send the same
+*  one-line commands, as many at once as they want, and get the answers back in the same order. bench/loadgen.cpp is a client that puts it under load.
+*
+*  Hash tables are efficient because you don't have to iterate across every student to check if they have the right ID,
+*  you just plug in the ID and it gives you the index!
+*/
+
+#include <iostream>
+#include <limits>
+#include <cstring>
+#include <cmath>
+#include <iomanip>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <map>
+#include <memory>
+#include "Student.h"
+#include "NamePool.h"
+#include "Parallel.h"
+#include "Hashers.h"
+#include "HashTable.h"
+#include "FlatTable.h"
+#include "StudentTable.h"
+#include "Snapshot.h"
+#include "Journal.h"
+#include "BatchOutput.h"
+#include "Server.h"
+using namespace std;
+
+//for ignoring faulty input and extra characters, functionality taken from my previous projects
+void CinIgnoreAll(bool force = false) {
+    if (!cin || force) { //only go if input is faulty, otherwise forces the user to input an extra enter
+        cin.clear(); //clears error flag
+        cin.ignore(numeric_limits<streamsize>::max(), '\n'); //ignores all characters up until a new line
+    }
+}
+
+//capitalizes the given string for easier command interpretation
+void AllCaps(string& word) {
+    for (size_t i = 0; i < word.size(); i++) { //sets all the characters to a capitalized unsigned version of the char (unsigned because some systems sign the chars)
+        word[i] = toupper((unsigned char)word[i]);
+    }
+}
+
+//for getting an integer from the player, ususally the id of a student
+int makeNum(bool id = true) { //id bool is for giving id error or normal error
+    int num = 0;
+    while (true) {
+        cout << "\n> ";
+        cin >> num; //gets the integer
+        if (cin) { //return the number and end the loop if input was valid
+            CinIgnoreAll(true); //removes the newline character after valid integer input
+            return num;
+        } else { //otherwise give error message and try again
+            if (id) { //id-specific error "\nID must be an integer."
+                cout << "\nID m";
+            } else { //generic integer error "\nMust be an integer."
+                cout << "\nM";
+            }
+            cout << "ust be an integer.";
+        }
+        CinIgnoreAll(); //removes the newline character or invalid input
+    }
+}
+
+const float MAX_GPA = 4.5; //the highest GPA a student can have, GENERATE gives out everything from 0 up to just under it
+
+//whether a student can have the GPA, false for NaN too since it fails both comparisons
+bool validGPA(float gpa) {
+    return gpa >= 0 && gpa <= MAX_GPA;
+}
+
+//for getting a GPA from the player, like when asking for a range of them
+float makeGPA() {
+    float gpa = 0;
+    while (true) {
+        cout << "\n> ";
+        cin >> gpa; //gets the gpa float
+        if (cin) { //return the gpa if input was valid
+            CinIgnoreAll(true); //removes the newline character after valid input
+            return gpa;
+        }
+        cout << "\nGPA must be a float."; //otherwise give error message and try again
+        CinIgnoreAll(); //removes the newline character or invalid input
+    }
+}
+
+//reads the data from a text file into a vector of strings (each line in the file is an item in the vector). quiet sends the error to cerr
+//instead, for batch and server mode where stdout only gets the commands' answers
+void readTxtData(const string& file, vector<string>& lines, bool quiet = false) { //needs the name of the file and the vector to write into
+    lines.clear(); //removes any existing data from the given vector, so we don't just inflate it on every RELOAD
+    ifstream txt(file); //opens the file
+    if (!txt) { //says error message if we couldn't open the file for some reason
+        (quiet ? cerr : cout) << "\nError encountered while opening " << file << ".";
+    } //no need to return because it just fails the for loop condition immediately and then the function ends anyway
+    //reads each line from txt and adds them to the vector of lines
+    for (string line; getline(txt, line); lines.push_back(line));
+}
+
+//takes the two names vectors and reads the associated files into them, (item in vector = line in file). quiet works like in readTxtData
+void loadNames(vector<string>& firstnames, vector<string>& lastnames, bool initial = false, bool quiet = false) {
+    readTxtData("firstnames.txt", firstnames, quiet); //reads the files into their corresponding vectors
+    readTxtData("lastnames.txt", lastnames, quiet);
+    ostream& messages = quiet ? cerr : cout;
+    bool faulty1 = firstnames.empty(); //gives errors if the vectors are empty for whatever reason
+    bool faulty2 = lastnames.empty();
+    if (faulty1 && faulty2) { //gives specific error, which one or if both files are faulty/empty
+        messages << "\nList of first and last names empty. GENERATE command disabled."; //both faulty
+    } else if (faulty1) { //first names faulty
+        messages << "\nList of first names empty. GENERATE command disabled.";
+    } else if (faulty2) { //last names faulty
+        messages << "\nList of last names empty. GENERATE command disabled.";
+    } else if (!initial) { //otherwise, success text! (unless it's the first one, because that runs without player input, so they don't need to know)
+        messages << "\nSuccessfully reloaded first and last name lists!";
+    }
+}
+
+//creates a new student with the values the user gives, needs the table as input so we can make sure to not repeat IDs, because that would cause infinite rehashing (since upon reaching 3 collisisons, the same 4 nodes would be rehashed into the same bucket again)
+template <class Table>
+Student createStudent(Table& table) {
+    string firstname;
+    string lastname;
+    int id;
+    float gpa;
+
+    //get the student's first (and middle if applicable) names
+    cout << "\nEnter first (and middle) name for new student.\n> ";
+    getline(cin, firstname);
+
+    //get the student's last name(s)
+    cout << "\nEnter last name(s) for new student.\n> ";
+    getline(cin, lastname);
+
+    //get the student's ID
+    cout << "\nEnter " << firstname << "'s student ID.";
+    bool continuing = true; //continues until valid input is given
+    while (continuing) {
+        id = makeNum(); //gets the ID using the number getting function, "\n> " is provided there
+        Student* student = table.find(id); //checks if the currently considered ID is taken for reasons stated above the createStudent function
+        continuing = student != NULL; //if the IDs match that's bad, so we keep continuing and get a new ID from the user because the IDs conflict
+        if (continuing) {
+            cout << "\nID " << id << " is taken by " << student->getName(0) << " " << student->getName(1) << "."; //error message; shows who is causing the conflict
+        }
+    }
+
+    //get the student's gpa
+    cout << "\nEnter " << firstname << "'s GPA.";
+    for (continuing = true; continuing;) { //continues until valid input is given
+        cout << "\n> ";
+        cin >> gpa; //gets the gpa float
+        if (cin && validGPA(gpa)) { //end loop if valid input was given
+            continuing = false;
+        } else if (cin) {
+            cout << "\nGPA must be between 0 and " << MAX_GPA << ".";
+        } else { //error message otherwise
+            cout << "\nGPA must be a float.";
+        }
+        CinIgnoreAll(true); //removes the newline character of invalid input
+    }
+
+    //creates and returns a new student using the given data
+    return Student(firstname, lastname, id, gpa);
+}
+
+//pseudorandomly generate a student with the given ID using the name files and a GPA between 0 and 4.5, returns false if the ID is taken.
+//The names are the name files' names already in the name pool, so making the student doesn't copy any text
+template <class Table>
+bool generateStudent(Table& table, const vector<uint32_t>& firstnames, const vector<uint32_t>& lastnames, int id, typename Table::hash_type hash,
+                     Journal* journal) {
+    if (table.find(id, hash) != NULL) { //if the ID is taken we don't generate anyone, and the caller tries the next ID
+        return false;
+    }
+    uint32_t firstname = firstnames[rand()%firstnames.size()]; //use the lists to choose one of each type of name
+    uint32_t lastname = lastnames[rand()%lastnames.size()];
+    float gpa = (rand()%450)/100.0; //generates a random gpa between 0.0 and 4.5
+
+    //creates a new student using the generated data and puts it in the table
+    Student student(firstname, lastname, id, gpa);
+    table.insert(id, student, hash);
+    if (journal != NULL) { //and in the journal if there is one
+        journal->add(student);
+    }
+    return true;
+}
+
+//pseudorandomly makes a student with the given ID for bulk generation. rand() can't be used from several threads at once, so every ID gets its
+//own little generator instead, seeded from the ID and the given seed so different GENERATEs still come out different
+Student randomStudent(const vector<uint32_t>& firstnames, const vector<uint32_t>& lastnames, int id, unsigned seed) {
+    minstd_rand rng(seed ^ (unsigned)id * 2654435761u); //multiplied by a big odd number so neighbouring IDs don't get neighbouring seeds
+    uint32_t firstname = firstnames[rng()%firstnames.size()];
+    uint32_t lastname = lastnames[rng()%lastnames.size()];
+    float gpa = (rng()%450)/100.0;
+    return Student(firstname, lastname, id, gpa);
+}
+
+//generates the given amount of students the bulk way: the table gets every ID at once and generates, hashes, and links the students on all
+//the cores, instead of one student at a time. IDs that are taken get skipped, and we just go again for however many are still missing
+template <class Table>
+void bulkGeneration(Table& table, const vector<uint32_t>& firstnames, const vector<uint32_t>& lastnames, int& genID, int amount, Journal* journal,
+                    bool progress) {
+    unsigned threads = defaultThreads();
+    if (progress) {
+        cout << "Generating on " << threads << " thread" << (threads == 1 ? "" : "s") << "..." << flush;
+    }
+    unsigned seed = rand(); //picked once here, since the threads can't call rand() themselves
+    vector<int> ids;
+    for (int made = 0; made < amount;) {
+        ids.resize(amount - made);
+        for (size_t j = 0; j < ids.size(); j++) {
+            ids[j] = genID + j;
+        }
+        made += table.bulkInsert(ids.data(), ids.size(), [&](size_t j) {
+            Student student = randomStudent(firstnames, lastnames, ids[j], seed);
+            if (journal != NULL) { //the journal can take records from all the threads at once
+                journal->add(student);
+            }
+            return student;
+        }, threads);
+        genID += ids.size(); //every one of these IDs was tried, whether or not it was taken
+    }
+}
+
+//generates the given amount of new students, printing the progress as it goes if progress is true
+template <class Table>
+void generateStudents(Table& table, vector<string>& firstnames, vector<string>& lastnames, int& genID, int amount, Journal* journal, bool progress) {
+    const int BULK_AMOUNT = 100000; //from this many students on, generating them all at once on every core is worth it
+    //every student gets their names from the name files, so they go in the name pool once here and the students just get the IDs. Names
+    //that were already in the pool keep their IDs, so this is the same every time unless the files got RELOADed with different names
+    vector<uint32_t> firstIDs = NamePool::InternAll(firstnames);
+    vector<uint32_t> lastIDs = NamePool::InternAll(lastnames);
+    if (amount >= BULK_AMOUNT) {
+        bulkGeneration(table, firstIDs, lastIDs, genID, amount, journal, progress);
+    } else {
+        //we know which IDs we're gonna try ahead of time (genID, genID+1, ...), so we hash them in batches, which is a lot faster for SHA-3
+        const int BATCH = 256;
+        vector<int> ids(BATCH);
+        vector<typename Table::hash_type> hashes(BATCH);
+        long long shown = -1; //the progress that's on screen right now, in hundredths of a percent
+        for (int i = 0; i < amount;) { //generates as many students as specified
+            int batch = min(BATCH, amount - i); //at least this many more IDs are needed, more if some are taken
+            for (int j = 0; j < batch; j++) {
+                ids[j] = genID + j;
+            }
+            table.hash(ids.data(), batch, hashes.data());
+            for (int j = 0; j < batch && i < amount; j++) {
+                genID = ids[j] + 1; //we only move genID past the IDs we actually tried, so none get skipped for next time
+                if (generateStudent(table, firstIDs, lastIDs, ids[j], hashes[j], journal)) { //skips the ID if it's taken, the next batch makes up for it
+                    i++;
+                    //prints the progress percentage in float form, for very large amounts (also overwrites the last percentage printing, looks more progress bar-y that way).
+                    //Only when the two decimals on screen would actually change though, flushing the terminal every single student takes longer than generating them
+                    if (progress && (long long)i * 10000 / amount != shown) {
+                        shown = (long long)i * 10000 / amount;
+                        cout << "\rProgress: " << i * 100.0 / amount << "%" << flush;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//get an amount from the player, and then generate that many new students
+template <class Table>
+void initGeneration(Table& table, vector<string>& firstnames, vector<string>& lastnames, int& genID, Journal* journal) {
+    if (!firstnames.size() || !lastnames.size()) { //if our name lists are empty due to file issues, we can't generate any students
+        cout << "\nNo valid names available; can't generate students."; //so we give an error and return, no generating allowed
+        return;
+    }
+    cout << "\nHow many students to generate?";
+    int amount = makeNum(false); //gets how many students to generate
+    cout << "\n"; //formatting!
+
+    generateStudents(table, firstnames, lastnames, genID, amount, journal, true);
+    cout << "\rSuccessfully generated " << amount << " student"; //overwrites the progress indicator with the success message! (looks better by overwriting rather than a new line)
+    if (amount != 1) { //make it plural if it wasn't specifically 1 student
+        cout << "s";
+    }
+    cout << "!"; //exclamation mark!
+}
+
+//creates a new student which the player can manually set the values for, and inserts it into the hash table
+template <class Table>
+void makeStudent(Table& table, Journal* journal) {
+    Student newguy = createStudent(table); //create the student with all their values
+    table.insert(newguy.getID(), newguy); //put the student in the table according to their ID's hash
+    if (journal != NULL) { //and in the journal if there is one
+        journal->add(newguy);
+    }
+    cout << "\nSuccessfully created " << newguy.getName(0) << "!"; //success text!
+}
+
+//prints the given student (with option to put the data in a new line)
+void printStudent(Student* student, bool newline = true) {
+    if (newline) { //prints the new line if we need to
+        cout << "\n";
+    } //prints all the student's data
+    cout << student->getName(0) << " " << student->getName(1) << " (" << student->getID() << ") - GPA of " << student->getGPA();
+}
+
+//uses id to find and delete a student in the hash table
+template <class Table>
+void deleteNode(Table& table, Journal* journal) {
+    cout << "\nEnter ID of student to delete.";
+    int id = makeNum(); //gets the ID from the player to search for
+    typename Table::hash_type hash = table.hash(id); //creates a hash based on the ID, used for both finding and deleting
+    Student* student = table.find(id, hash);
+    if (student == NULL) { //error, no student with ID id found
+        cout << "\nNo student found with ID " << id << ".";
+        return;
+    }
+    cout << "\nDeleted " << student->getName(0) << " " << student->getName(1) << "."; //deletion success text! (before deleting since that deletes the student too)
+    table.erase(id, hash); //deletes the student
+    if (journal != NULL) {
+        journal->remove(id);
+    }
+}
+
+//prints the average gpa of all the students, which the table keeps a running total of so there's no walking through every student
+template <class Table>
+void average(Table& table) {
+    const GpaColumn& gpas = table.gpas();
+    if (gpas.size() == 0) { //if there's nobody, we give error message and return
+        cout << "\nThere are no students with GPAs to average. (type ADD for add)";
+        return;
+    } //print the average gpa to two decimals of precision
+    cout << "\nAverage GPA: " << gpas.average();
+    cout << "\nLowest GPA: " << gpas.lowest() << "\nHighest GPA: " << gpas.highest();
+    cout << "\nStandard deviation: " << sqrt(gpas.variance());
+}
+
+//prints what the table's stats and shape say, one per line
+template <class Table>
+void printStats(Table& table) {
+    vector<pair<string, string> > fields = table.stats().fields(table.shape());
+    cout << "\nTable stats:";
+    for (pair<string, string>& field : fields) {
+        cout << "\n  " << left << setw(26) << field.first + ":" << right << field.second;
+    }
+    if (!TableStats::ENABLED) {
+        cout << "\n(the counters were compiled out, build with STATS=1 to get them)";
+    }
+}
+
+//builds the frozen table so lookups go to it until the next change, and says how long that took and how much memory it takes
+template <class Table>
+void freeze(Table& table) {
+    table.freeze();
+    const FrozenTable& frozen = table.frozenTable();
+    cout << "\nFroze " << frozen.size() << " student" << (frozen.size() == 1 ? "" : "s") << " in " << frozen.buildMillis() << " ms ("
+         << (frozen.size() ? (double)frozen.bytes() / frozen.size() : 0) << " bytes each). Lookups use the frozen copy until the next change.";
+}
+
+//print all the students' data by iterating through the table
+template <class Table>
+void printAll(Table& table) {
+    if (table.empty()) { //check if there's any students to print
+        cout << "\nThere are no students to print."; //if not, error and return
+        return;
+    }
+    cout << "\nStudents:";
+    size_t cursor = 0; //goes through the table a batch at a time with scan, see Cursor.h
+    do {
+        cursor = table.scan(cursor, 1024, [](int, Student& student, uint64_t) {
+            printStudent(&student); //prints the current student data
+        });
+    } while (cursor != 0);
+}
+
+//prints everyone with the last name the user asks for, straight from the last name index if it's on
+template <class Table>
+void findLastName(Table& table) {
+    string name;
+    cout << "\nEnter the last name to look for.\n> ";
+    getline(cin, name);
+    size_t found = table.withLastName(name, [](Student& student) {
+        printStudent(&student);
+    });
+    if (!found) {
+        cout << "\nNobody is named " << name << ".";
+    }
+}
+
+//prints everyone with a GPA in the range the user asks for, lowest first if the GPA index is on
+template <class Table>
+void gpaRange(Table& table) {
+    cout << "\nEnter the lowest GPA.";
+    float low = makeGPA();
+    cout << "\nEnter the highest GPA.";
+    float high = makeGPA();
+    size_t found = table.withGpaBetween(low, high, [](Student& student) {
+        printStudent(&student);
+    });
+    if (!found) {
+        cout << "\nNobody has a GPA from " << low << " to " << high << ".";
+    }
+}
+
+//asks for a file name and saves every student into a snapshot there
+template <class Table>
+void saveSnapshot(Table& table, int genID) {
+    string path;
+    cout << "\nEnter file name to save to.\n> ";
+    getline(cin, path);
+    string error;
+    if (Snapshot::Save(table, path, genID, error)) {
+        cout << "\nSaved " << table.size() << " student" << (table.size() == 1 ? "" : "s") << " to " << path << "!";
+    } else {
+        cout << "\nCouldn't save, " << error << ".";
+    }
+}
+
+//asks for a file name and replaces all the students with the ones in the snapshot there
+template <class Table>
+void loadSnapshot(Table& table, int& genID, Journal* journal) {
+    string path;
+    cout << "\nEnter file name to load from.\n> ";
+    getline(cin, path);
+    string error;
+    if (Snapshot::Load(table, path, genID, error)) {
+        cout << "\nLoaded " << table.size() << " student" << (table.size() == 1 ? "" : "s") << " from " << path << "!";
+        if (journal != NULL) { //the journal only has changes, and this replaced everything, so it starts over from a snapshot of the new students
+            journal->compactNow(table, genID); //not in the background, the old journal must never end up replayed on top of these
+        }
+    } else {
+        cout << "\nCouldn't load " << path << ", " << error << ".";
+    }
+}
+
+//the command loop, templated on the table engine so everything in it is resolved at compile time
+template <class Table>
+void commandLoop(Table& table, vector<string>& firstNames, vector<string>& lastNames, int& genID, Journal* journal) {
+    string command; //the command that the user inputs into (now outside the loop! how exciting!)
+    bool warned = false; //whether we already warned that the journal failed
+    //continues until continuing is falsified (by typing QUIT)
+    for (bool continuing = true; continuing;) {
+        cout << "\n> "; //thing for the player to type after
+
+        getline(cin, command); //gets the player input, up to 255 characters
+
+        AllCaps(command); //capitalizes the command for easier interpretation
+
+        //calls function corresponding to the given command word
+        if (command == "ADD") { //add student
+            makeStudent(table, journal);
+        } else if (command == "GENERATE") { //randomly generate new student(s)
+            initGeneration(table, firstNames, lastNames, genID, journal);
+        } else if (command == "DELETE") { //delete student
+            deleteNode(table, journal);
+        } else if (command == "PRINT") { //print all students
+            printAll(table);
+        } else if (command == "AVERAGE") { //print average gpa of all students
+            average(table);
+        } else if (command == "LASTNAME") { //print everyone with a last name
+            findLastName(table);
+        } else if (command == "RANGE") { //print everyone in a range of gpas
+            gpaRange(table);
+        } else if (command == "STATS") { //print what's going on inside the table
+            printStats(table);
+        } else if (command == "FREEZE") { //make a read-only copy for fast lookups
+            freeze(table);
+        } else if (command == "SAVE") { //save all students to a file
+            saveSnapshot(table, genID);
+        } else if (command == "LOAD") { //replace all students with the ones in a file
+            loadSnapshot(table, genID, journal);
+        } else if (command == "RELOAD") { //reload name files
+            loadNames(firstNames, lastNames);
+        } else if (command == "HELP") { //print all valid command words
+            cout << "\nYour command words are:\nADD      - Manually create a new student.\nGENERATE - Randomly generate a given amount of students.\nDELETE   - Delete an existing student by ID.\nPRINT    - Print the data of all students.\nAVERAGE  - Calculate the average GPA of all students.\nLASTNAME - Print every student with a given last name.\nRANGE    - Print every student with a GPA in a given range.\nSTATS    - Print the table's statistics.\nFREEZE   - Make a read-only copy of the students for faster lookups.\nSAVE     - Save all students to a file.\nLOAD     - Replace all students with the ones saved in a file.\nRELOAD   - Reload the two name files.\nHELP     - Print all valid commands.\nQUIT     - Exit the program.";
+        } else if (command == "QUIT") { //quit the program
+            continuing = false; //leave the main player loop
+        } else { //give error message if the user typed something unacceptable
+            cout << "\nInvalid command \"" << command << "\". (type HELP for help)";
+        }
+        if (journal != NULL && journal->wantsCompaction()) { //the journal got big, so the students go in a snapshot and the journal starts over
+            journal->compact(table, genID);
+        }
+        if (journal != NULL && journal->hasFailed() && !warned) { //only says it once, it's not going to fix itself
+            cout << "\nWarning: writing to the journal failed, changes from now on might not be saved!";
+            warned = true;
+        }
+    }
+}
+
+//splits the line into its words (separated by spaces or tabs), reusing the vector's strings so a line usually doesn't allocate anything
+void splitWords(const string& line, vector<string>& words) {
+    size_t count = 0;
+    for (size_t i = 0; i < line.size();) {
+        if (line[i] == ' ' || line[i] == '\t' || line[i] == '\r') { //\r too, in case the script has windows line endings
+            i++;
+            continue;
+        }
+        size_t end = line.find_first_of(" \t\r", i);
+        if (end == string::npos) {
+            end = line.size();
+        }
+        if (count == words.size()) {
+            words.emplace_back();
+        }
+        words[count++].assign(line, i, end - i);
+        i = end;
+    }
+    words.resize(count);
+}
+
+//reads the whole word as a number into num, returns false if it isn't one
+bool parseNum(const string& word, int& num) {
+    char* end;
+    long value = strtol(word.c_str(), &end, 10);
+    num = value;
+    return !word.empty() && *end == '\0' && value == num;
+}
+bool parseNum(const string& word, size_t& num) { //for cursors and counts, which can't be negative
+    char* end;
+    num = strtoull(word.c_str(), &end, 10);
+    return !word.empty() && isdigit((unsigned char)word[0]) && *end == '\0';
+}
+bool parseNum(const string& word, float& num) { //strtof takes "nan" and "inf" too, which aren't GPAs or ends of a range
+    char* end;
+    num = strtof(word.c_str(), &end);
+    return !word.empty() && *end == '\0' && isfinite(num);
+}
+
+//the read views that VIEW opened and nobody closed or read to the end yet, by the number VIEW answered with. There's one for the whole
+//server, so a client can open a view and have others read it, and the numbers never get reused so a closed view can't turn into someone else's
+struct OpenViews {
+    map<size_t, shared_ptr<ReadView> > open;
+    size_t next = 1;
+};
+
+//runs one batch mode command, with all its arguments on the line, and answers it with a line starting with OK or ERR (the line number
+//goes in the errors so a script can tell which command failed). Used by both batch mode and the server, returns false if the command was QUIT
+template <class Table>
+bool runCommand(Table& table, const string& line, long long lineNumber, vector<string>& words, BatchOutput& out, OpenViews& views,
+                vector<string>& firstNames, vector<string>& lastNames, int& genID, Journal* journal) {
+    splitWords(line, words);
+    if (words.empty() || words[0][0] == '#') { //blank lines and comments
+        return true;
+    }
+    AllCaps(words[0]);
+    const string& command = words[0];
+    int id;
+    float gpa;
+    if (command == "GET" && words.size() == 2) {
+        Student* student;
+        if (!parseNum(words[1], id)) {
+            out << "ERR line " << lineNumber << ": ID must be an integer\n";
+        } else if ((student = table.find(id)) != NULL) {
+            out << "OK " << student->getName(0) << ' ' << student->getName(1) << ' ' << (double)student->getGPA() << '\n';
+        } else {
+            out << "ERR line " << lineNumber << ": no student with ID " << id << "\n";
+        }
+    } else if (command == "GET" && words.size() > 2) { //several IDs are all looked up in one findMany, and answered like PRINT
+        vector<int> ids(words.size() - 1);
+        bool parsed = true;
+        for (size_t i = 1; i < words.size() && parsed; i++) {
+            parsed = parseNum(words[i], ids[i - 1]);
+        }
+        if (!parsed) {
+            out << "ERR line " << lineNumber << ": IDs must be integers\n";
+        } else {
+            vector<Student*> students(ids.size());
+            table.findMany(ids.data(), ids.size(), students.data());
+            size_t found = 0;
+            for (size_t i = 0; i < ids.size(); i++) {
+                if (students[i] != NULL) {
+                    out << ids[i] << ' ' << students[i]->getName(0) << ' ' << students[i]->getName(1) << ' ' << (double)students[i]->getGPA() << '\n';
+                    found++;
+                }
+            }
+            out << "OK " << found << "\n";
+        }
+    } else if (command == "ADD" && words.size() == 5) {
+        if (!parseNum(words[3], id) || !parseNum(words[4], gpa)) {
+            out << "ERR line " << lineNumber << ": ID must be an integer and GPA must be a float\n";
+        } else if (!validGPA(gpa)) {
+            out << "ERR line " << lineNumber << ": GPA must be between 0 and " << MAX_GPA << "\n";
+        } else {
+            Student student(words[1], words[2], id, gpa);
+            if (table.insert(id, student)) {
+                if (journal != NULL) {
+                    journal->add(student);
+                }
+                out << "OK\n";
+            } else {
+                out << "ERR line " << lineNumber << ": ID " << id << " is taken\n";
+            }
+        }
+    } else if (command == "DELETE" && words.size() == 2) {
+        if (!parseNum(words[1], id)) {
+            out << "ERR line " << lineNumber << ": ID must be an integer\n";
+        } else if (table.erase(id)) {
+            if (journal != NULL) {
+                journal->remove(id);
+            }
+            out << "OK\n";
+        } else {
+            out << "ERR line " << lineNumber << ": no student with ID " << id << "\n";
+        }
+    } else if (command == "GENERATE" && words.size() == 2) {
+        if (!parseNum(words[1], id) || id <= 0) {
+            out << "ERR line " << lineNumber << ": amount must be a positive integer\n";
+        } else if (firstNames.empty() || lastNames.empty()) {
+            out << "ERR line " << lineNumber << ": no valid names available\n";
+        } else {
+            generateStudents(table, firstNames, lastNames, genID, id, journal, false);
+            out << "OK " << id << "\n";
+        }
+    } else if (command == "PRINT" && words.size() == 1) { //one line per student, then how many there were
+        size_t cursor = 0;
+        do {
+            cursor = table.scan(cursor, 1024, [&](int id, Student& student, uint64_t) {
+                out << id << ' ' << student.getName(0) << ' ' << student.getName(1) << ' ' << (double)student.getGPA() << '\n';
+            });
+        } while (cursor != 0);
+        out << "OK " << table.size() << "\n";
+    } else if (command == "SCAN" && (words.size() == 2 || words.size() == 3)) { //one batch of PRINT, then the cursor to pass next time
+        size_t cursor;
+        size_t count = 100;
+        if (!parseNum(words[1], cursor) || (words.size() == 3 && (!parseNum(words[2], count) || count == 0))) {
+            out << "ERR line " << lineNumber << ": bad cursor or count\n";
+        } else {
+            cursor = table.scan(cursor, count, [&](int id, Student& student, uint64_t) {
+                out << id << ' ' << student.getName(0) << ' ' << student.getName(1) << ' ' << (double)student.getGPA() << '\n';
+            });
+            out << "OK " << cursor << "\n";
+        }
+    } else if (command == "VIEW" && words.size() == 1) { //opens a point-in-time view of every student for READ, answers with its number
+        views.open[views.next] = table.openView();
+        out << "OK " << views.next++ << "\n";
+    } else if (command == "READ" && (words.size() == 2 || words.size() == 3)) { //like SCAN, but out of the view, then how many students it has left
+        size_t number;
+        size_t count = 100;
+        map<size_t, shared_ptr<ReadView> >::iterator view;
+        if (!parseNum(words[1], number) || (words.size() == 3 && (!parseNum(words[2], count) || count == 0))) {
+            out << "ERR line " << lineNumber << ": bad view or count\n";
+        } else if ((view = views.open.find(number)) == views.open.end()) {
+            out << "ERR line " << lineNumber << ": no open view " << number << "\n";
+        } else {
+            size_t left = table.read(*view->second, count, [&](int id, Student& student) {
+                out << id << ' ' << student.getName(0) << ' ' << student.getName(1) << ' ' << (double)student.getGPA() << '\n';
+            });
+            if (left == 0) { //read to the end, so it closes itself
+                views.open.erase(view);
+            }
+            out << "OK " << left << "\n";
+        }
+    } else if (command == "CLOSE" && words.size() == 2) { //closes a view without reading the rest of it
+        size_t number;
+        if (!parseNum(words[1], number) || views.open.erase(number) == 0) {
+            out << "ERR line " << lineNumber << ": no open view " << words[1] << "\n";
+        } else {
+            out << "OK\n";
+        }
+    } else if (command == "AVERAGE" && words.size() == 1) {
+        if (table.empty()) {
+            out << "ERR line " << lineNumber << ": no students\n";
+        } else {
+            out << "OK " << table.gpas().average() << "\n";
+        }
+    } else if (command == "AVERAGE" && words.size() == 3) { //only the GPAs from low to high, scanned straight out of the column
+        float low, high;
+        size_t matched;
+        if (!parseNum(words[1], low) || !parseNum(words[2], high)) {
+            out << "ERR line " << lineNumber << ": bad GPA range\n";
+        } else {
+            double sum = table.gpas().sumBetween(low, high, matched);
+            if (matched == 0) {
+                out << "ERR line " << lineNumber << ": no students in that range\n";
+            } else {
+                out << "OK " << sum / matched << ' ' << matched << "\n";
+            }
+        }
+    } else if ((command == "LASTNAME" && words.size() == 2) || (command == "RANGE" && words.size() == 3)) { //one line per student, like PRINT
+        float low, high;
+        size_t found;
+        auto print = [&](Student& student) {
+            out << student.getID() << ' ' << student.getName(0) << ' ' << student.getName(1) << ' ' << (double)student.getGPA() << '\n';
+        };
+        if (command == "LASTNAME") {
+            found = table.withLastName(words[1], print);
+            out << "OK " << found << "\n";
+        } else if (!parseNum(words[1], low) || !parseNum(words[2], high)) {
+            out << "ERR line " << lineNumber << ": bad GPA range\n";
+        } else {
+            found = table.withGpaBetween(low, high, print);
+            out << "OK " << found << "\n";
+        }
+    } else if (command == "FREEZE" && words.size() == 1) {
+        table.freeze();
+        out << "OK " << table.frozenTable().size() << "\n";
+    } else if (command == "STATS" && words.size() == 1) { //every stat as name=value on the one line, so a script can split it up
+        vector<pair<string, string> > fields = table.stats().fields(table.shape());
+        out << "OK";
+        for (pair<string, string>& field : fields) {
+            out << ' ' << field.first << '=' << field.second;
+        }
+        out << '\n';
+    } else if ((command == "SAVE" || command == "LOAD") && words.size() == 2) {
+        string error;
+        if (command == "SAVE" ? Snapshot::Save(table, words[1], genID, error) : Snapshot::Load(table, words[1], genID, error)) {
+            if (command == "LOAD" && journal != NULL) { //same as the interactive LOAD, the journal starts over
+                journal->compactNow(table, genID);
+            }
+            out << "OK " << table.size() << "\n";
+        } else {
+            out << "ERR line " << lineNumber << ": " << error << "\n";
+        }
+    } else if (command == "QUIT" && words.size() == 1) {
+        return false;
+    } else {
+        out << "ERR line " << lineNumber << ": invalid command \"" << line << "\"\n";
+    }
+    if (journal != NULL && journal->wantsCompaction()) {
+        journal->compact(table, genID);
+    }
+    return true;
+}
+
+//the batch mode command loop: reads one command per line from in until QUIT or the end of the input, everything goes through one big output buffer
+template <class Table>
+void batchLoop(Table& table, istream& in, vector<string>& firstNames, vector<string>& lastNames, int& genID, Journal* journal) {
+    BatchOutput out;
+    string line;
+    vector<string> words; //reused for every line so splitting them doesn't allocate
+    OpenViews views;
+    for (long long lineNumber = 1; getline(in, line); lineNumber++) {
+        if (!runCommand(table, line, lineNumber, words, out, views, firstNames, lastNames, genID, journal)) {
+            break;
+        }
+    }
+    if (journal != NULL && journal->hasFailed()) {
+        out << "ERR writing to the journal failed, changes might not be saved\n";
+    }
+}
+
+//server mode: answers the batch mode commands of every client connecting to the socket at the given path, until the server gets stopped
+template <class Table>
+void serve(Table& table, const string& socketPath, vector<string>& firstNames, vector<string>& lastNames, int& genID, Journal* journal) {
+    Server server;
+    string error;
+    if (!server.listen(socketPath, error)) {
+        cerr << "Couldn't serve on " << socketPath << ", " << error << ".\n";
+        return;
+    }
+    cout << "Serving " << table.size() << " student" << (table.size() == 1 ? "" : "s") << " on " << socketPath << ". (Ctrl+C to stop)\n" << flush;
+    vector<string> words; //only ever one command at a time, so every connection can share it
+    OpenViews views;
+    server.run([&](const string& line, long long lineNumber, BatchOutput& out) {
+        return runCommand(table, line, lineNumber, words, out, views, firstNames, lastNames, genID, journal);
+    });
+    if (journal != NULL && journal->hasFailed()) {
+        cerr << "Writing to the journal failed, changes might not be saved.\n";
+    }
+}
+
+//gets the students back from the journal (if there is one) and then runs the command loop on the table
+template <class Table>
+void recoverAndRun(Table& table, vector<string>& firstNames, vector<string>& lastNames, int& genID, Journal* journal, istream* batch,
+                   const string& socketPath) {
+    bool quiet = batch != NULL || !socketPath.empty(); //batch and server mode only print what the commands answer
+    if (journal != NULL) {
+        size_t replayed;
+        string error;
+        if (!journal->recover(table, genID, replayed, error)) {
+            (quiet ? cerr : cout) << "\n\nCouldn't open the journal, " << error << ". Changes won't be saved!";
+        } else if (!quiet && (replayed > 0 || !table.empty())) {
+            cout << "\n\nRecovered " << table.size() << " student" << (table.size() == 1 ? "" : "s") << " from the journal (" << replayed << " change"
+                 << (replayed == 1 ? "" : "s") << " replayed).";
+        }
+    }
+    if (batch != NULL) {
+        batchLoop(table, *batch, firstNames, lastNames, genID, journal);
+        return;
+    }
+    if (!socketPath.empty()) {
+        serve(table, socketPath, firstNames, lastNames, genID, journal);
+        return;
+    }
+    if (table.empty()) {
+        cout << "\n\nThere are currently no students. (type ADD for add)";
+    }
+    commandLoop(table, firstNames, lastNames, genID, journal);
+}
+
+//makes the table with the picked engine and hasher and runs the command loop on it, the tables delete all their students when they go out of scope
+template <class Hasher>
+void runTable(bool flat, size_t buckets, bool indexed, bool filtered, vector<string>& firstNames, vector<string>& lastNames, int& genID, Journal* journal, istream* batch,
+              const string& socketPath) {
+    if (flat) {
+        StudentTable<FlatTable<int, Student, Hasher> > table(buckets); //the flat table of inline students
+        table.setIndexed(indexed); //before recovering, so the recovered students get indexed (and filtered) as they come in
+        table.setFiltered(filtered);
+        recoverAndRun(table, firstNames, lastNames, genID, journal, batch, socketPath);
+    } else {
+        StudentTable<HashTable<int, Student, Hasher> > table(buckets); //the hash table of linked list chains
+        table.setIndexed(indexed);
+        table.setFiltered(filtered);
+        recoverAndRun(table, firstNames, lastNames, genID, journal, batch, socketPath);
+    }
+}
+
+//the main function, picks the table engine and hasher and then runs the command loop on them
+int main(int argc, char* argv[]) {
+    bool flat = false; //whether we use the flat table engine instead of the chained one
+    size_t buckets = 128; //how big the table starts out, and the smallest it ever shrinks to
+    string hasher = "sha3"; //which hasher to use
+    bool indexed = false; //whether to keep the last name and GPA indexes
+    bool filtered = false; //whether to put the cuckoo filter in front of the table
+    string journalPath; //where to journal changes to, empty if we aren't journaling
+    Journal::SyncPolicy policy = Journal::SYNC_GROUP; //how often the journal gets fsynced
+    unsigned groupMillis = 100;
+    bool batch = false; //whether we're in batch mode
+    string batchPath; //the file to read the batch commands from, empty for stdin
+    string socketPath; //the socket to serve the table on, empty if we aren't a server
+    for (int i = 1; i < argc; i++) { //go through the command line arguments
+        string arg = argv[i];
+        if (arg == "--engine=flat") {
+            flat = true;
+        } else if (arg == "--engine=chained") { //chained is the default so it doesn't do anything
+            flat = false;
+        } else if (arg == "--hash=sha3" || arg == "--hash=wyhash" || arg == "--hash=mix") {
+            hasher = arg.substr(7); //everything after "--hash="
+        } else if (arg.compare(0, 10, "--journal=") == 0 && arg.size() > 10) {
+            journalPath = arg.substr(10);
+        } else if (arg.compare(0, 10, "--buckets=") == 0 && arg.size() > 10 && isdigit((unsigned char)arg[10])) {
+            buckets = strtoull(arg.c_str() + 10, NULL, 10);
+        } else if (arg == "--index") {
+            indexed = true;
+        } else if (arg == "--filter") {
+            filtered = true;
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg.compare(0, 8, "--batch=") == 0 && arg.size() > 8) {
+            batch = true;
+            batchPath = arg.substr(8);
+        } else if (arg.compare(0, 8, "--serve=") == 0 && arg.size() > 8) {
+            socketPath = arg.substr(8);
+        } else if (arg == "--fsync=always") {
+            policy = Journal::SYNC_ALWAYS;
+        } else if (arg == "--fsync=never") {
+            policy = Journal::SYNC_NEVER;
+        } else if (arg.compare(0, 8, "--fsync=") == 0 && arg.size() > 8 && isdigit((unsigned char)arg[8])) {
+            policy = Journal::SYNC_GROUP;
+            groupMillis = atoi(arg.c_str() + 8);
+        } else {
+            cout << "\nUnknown argument \"" << arg << "\". (valid arguments are --engine=chained, --engine=flat, --buckets=<amount>, --hash=sha3, --hash=wyhash,"
+                 << " --hash=mix, --journal=<file>, --fsync=always, --fsync=never, --fsync=<milliseconds>, --index, --filter, --batch, --batch=<file> and --serve=<socket>)\n";
+            return 1;
+        }
+    }
+
+    vector<string> firstNames; //the vectors of names that are used to pseudorandomly generate students
+    vector<string> lastNames;
+
+    int genID = 1; //the ID used when randomly generating a student, gets incremented after every generation
+
+    srand(time(NULL)); //seed the random number generation with the time, so the random student generation can use it
+
+    ifstream batchFile; //the batch commands, if they come from a file
+    istream* batchInput = NULL; //where the batch commands come from, NULL if we're interactive
+    if (batch && batchPath.empty()) {
+        ios::sync_with_stdio(false); //cin gets its own buffer instead of reading through stdio one character at a time
+        batchInput = &cin;
+    } else if (batch) {
+        batchFile.open(batchPath);
+        if (!batchFile) {
+            cerr << "Couldn't open the batch file \"" << batchPath << "\".\n";
+            return 1;
+        }
+        batchInput = &batchFile;
+    }
+
+    bool quiet = batch || !socketPath.empty(); //batch and server mode skip the welcome and goodbye
+    if (!quiet) { //welcome message with instructions, also sets float printings to 2 decimal points of precision
+        cout << "\nHello I am Harry the hash table!\nI am managing a database of students.\nType HELP for help." << fixed << setprecision(2);
+    }
+    loadNames(firstNames, lastNames, true, quiet); //loads the names from the files "firstnames.txt" and "lastnames.txt"
+
+    Journal* journal = journalPath.empty() ? NULL : new Journal(journalPath, policy, groupMillis);
+    if (hasher == "wyhash") { //every hasher is its own template instantiation, so this is the only place the hasher is picked at runtime
+        runTable<WyHasher>(flat, buckets, indexed, filtered, firstNames, lastNames, genID, journal, batchInput, socketPath);
+    } else if (hasher == "mix") {
+        runTable<MixHasher>(flat, buckets, indexed, filtered, firstNames, lastNames, genID, journal, batchInput, socketPath);
+    } else {
+        runTable<SHA3Hasher>(flat, buckets, indexed, filtered, firstNames, lastNames, genID, journal, batchInput, socketPath);
+    }
+    delete journal; //writes out and fsyncs whatever changes are left
+
+
+    if (!quiet) { //says bye
+        cout <<"\nPeace out.\n";
+    }
+}